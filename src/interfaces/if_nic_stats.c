@@ -11,7 +11,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
-#include <ifaddrs.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -20,106 +21,631 @@
 #include <linux/ethtool.h>
 #include <linux/sockios.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <netlink/netlink.h>
+
+// the statistics dump needs the uapi headers of linux 5.13 or newer - the ioctl is used alone otherwise
+#ifdef HAVE_ETHTOOL_NETLINK_STATS
+#include <linux/ethtool_netlink.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+#endif
 
 #include "if_nic_stats.h"
 #include "utils/memory.h"
 
-int get_nic_stats(char *if_name, nic_stats_t *nic_stats)
+#define NIC_STATS_INITIAL_SIZE 64
+
+// ethtool names of the counters, indexed by enum nic_stats_counter
+static const char *NIC_STATS_NAMES[NIC_STATS_COUNTER_COUNT] = {
+	[NIC_STATS_RX_PACKETS] = "rx_packets",
+	[NIC_STATS_RX_BROADCAST] = "rx_broadcast",
+	[NIC_STATS_TX_PACKETS] = "tx_packets",
+	[NIC_STATS_TX_BROADCAST] = "tx_broadcast",
+	[NIC_STATS_TX_MULTICAST] = "tx_multicast",
+};
+
+#ifdef HAVE_ETHTOOL_NETLINK_STATS
+// counters as reported in the standard MAC statistics group (IEEE 802.3 30.3.1.1), indexed by enum nic_stats_counter
+static const int NIC_STATS_ETH_MAC_ATTRS[NIC_STATS_COUNTER_COUNT] = {
+	[NIC_STATS_RX_PACKETS] = ETHTOOL_A_STATS_ETH_MAC_5_RX_PKT,
+	[NIC_STATS_RX_BROADCAST] = ETHTOOL_A_STATS_ETH_MAC_22_RX_BCAST,
+	[NIC_STATS_TX_PACKETS] = ETHTOOL_A_STATS_ETH_MAC_2_TX_PKT,
+	[NIC_STATS_TX_BROADCAST] = ETHTOOL_A_STATS_ETH_MAC_19_TX_BCAST,
+	[NIC_STATS_TX_MULTICAST] = ETHTOOL_A_STATS_ETH_MAC_18_TX_MCAST,
+};
+
+static int nic_stats_engine_dump_cb(struct nl_msg *msg, void *arg);
+static unsigned int nic_stats_engine_parse_group(struct nlattr *group, uint64_t values[NIC_STATS_COUNTER_COUNT]);
+#endif
+static void nic_stats_engine_next_generation(nic_stats_engine_t *engine);
+static nic_stats_entry_t *nic_stats_engine_lookup(nic_stats_engine_t *engine, int ifindex);
+static unsigned int nic_stats_engine_find_slot(nic_stats_engine_t *engine, int ifindex);
+static nic_stats_entry_t *nic_stats_engine_add(nic_stats_engine_t *engine, int ifindex);
+static void nic_stats_engine_resize(nic_stats_engine_t *engine, unsigned int entries_size);
+static int nic_stats_engine_resolve(nic_stats_engine_t *engine, struct ifreq *ifr, nic_stats_entry_t *entry);
+static void nic_stats_engine_reserve_stats(nic_stats_engine_t *engine, unsigned int n_stats);
+
+int nic_stats_engine_init(nic_stats_engine_t *engine)
 {
-	int skfd = -1;
-	struct ethtool_drvinfo drvinfo = {0};
-	struct ethtool_gstrings *gstrings = NULL;
-	struct ethtool_stats    *stats   = NULL;
-	struct ifreq ifr = {0};
-	unsigned int n_stats = 0;
-	unsigned int sz_str = 0;
-	unsigned int sz_stats = 0;
+	engine->entries = NULL;
+	engine->entries_size = 0;
+	engine->count = 0;
+	engine->stats = NULL;
+	engine->stats_capacity = 0;
+	engine->gstrings = NULL;
+	engine->gstrings_capacity = 0;
+	engine->genl_socket = NULL;
+	engine->genl_family = 0;
+	engine->generation = 0;
+	engine->invalidations = 0;
 
-	skfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if (skfd < 0) {
-		goto error_out;
+	engine->skfd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (engine->skfd < 0) {
+		return -1;
 	}
 
-	// set interface name
-	strncpy(&ifr.ifr_name[0], if_name, IFNAMSIZ);
-	ifr.ifr_name[IFNAMSIZ - 1] = 0;
+	if (pthread_mutex_init(&engine->lock, NULL) != 0) {
+		close(engine->skfd);
+		engine->skfd = -1;
+		return -1;
+	}
 
-	// how many stats are available
-	drvinfo.cmd = ETHTOOL_GDRVINFO;
-	ifr.ifr_data = (caddr_t) &drvinfo;
+	if (pthread_mutex_init(&engine->io_lock, NULL) != 0) {
+		pthread_mutex_destroy(&engine->lock);
+		close(engine->skfd);
+		engine->skfd = -1;
+		return -1;
+	}
+
+#ifdef HAVE_ETHTOOL_NETLINK_STATS
+	// the netlink backend is optional - without the ethtool family every link is read with the ioctl
+	engine->genl_socket = nl_socket_alloc();
+	if (engine->genl_socket == NULL) {
+		return 0;
+	}
 
-	if (ioctl(skfd, SIOCETHTOOL, &ifr) != 0) {
+	if (genl_connect(engine->genl_socket) == 0) {
+		engine->genl_family = genl_ctrl_resolve(engine->genl_socket, ETHTOOL_GENL_NAME);
+	}
+
+	if (engine->genl_family <= 0) {
+		nl_socket_free(engine->genl_socket);
+		engine->genl_socket = NULL;
+		engine->genl_family = 0;
+		return 0;
+	}
+
+	nl_socket_modify_cb(engine->genl_socket, NL_CB_VALID, NL_CB_CUSTOM, nic_stats_engine_dump_cb, engine);
+#endif
+
+	return 0;
+}
+
+#ifdef HAVE_ETHTOOL_NETLINK_STATS
+int nic_stats_engine_refresh(nic_stats_engine_t *engine, int ifindex)
+{
+	int error = 0;
+	struct nl_msg *msg = NULL;
+	struct nlattr *header = NULL;
+	struct nlattr *groups = NULL;
+	const uint32_t GROUPS = 1u << ETHTOOL_STATS_ETH_MAC;
+
+	pthread_mutex_lock(&engine->io_lock);
+
+	if (engine->genl_family == 0) {
+		goto out;
+	}
+
+	msg = nlmsg_alloc();
+	if (msg == NULL) {
 		goto error_out;
 	}
 
-	n_stats = drvinfo.n_stats;
-	if (n_stats < 1) {
+	if (genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, engine->genl_family, 0, ifindex > 0 ? 0 : NLM_F_DUMP, ETHTOOL_MSG_STATS_GET, ETHTOOL_GENL_VERSION) == NULL) {
 		goto error_out;
 	}
 
-	// allocate memory for stat names and values
-	sz_str = n_stats * ETH_GSTRING_LEN;
-	sz_stats = n_stats * sizeof(uint64_t);
+	// a single link is requested by its index in the request header
+	if (ifindex > 0) {
+		header = nla_nest_start(msg, ETHTOOL_A_STATS_HEADER);
+		if (header == NULL || nla_put_u32(msg, ETHTOOL_A_HEADER_DEV_INDEX, (uint32_t) ifindex) != 0) {
+			goto error_out;
+		}
+		nla_nest_end(msg, header);
+	}
+
+	// requested statistics groups as a compact bitset
+	groups = nla_nest_start(msg, ETHTOOL_A_STATS_GROUPS);
+	if (groups == NULL ||
+		nla_put_flag(msg, ETHTOOL_A_BITSET_NOMASK) != 0 ||
+		nla_put_u32(msg, ETHTOOL_A_BITSET_SIZE, ETHTOOL_STATS_ETH_MAC + 1) != 0 ||
+		nla_put(msg, ETHTOOL_A_BITSET_VALUE, sizeof(GROUPS), &GROUPS) != 0) {
+		goto error_out;
+	}
+	nla_nest_end(msg, groups);
 
-	gstrings = xcalloc(1, sz_str + sizeof(struct ethtool_gstrings));
+	// values of the previous dump become stale
+	pthread_mutex_lock(&engine->lock);
+	nic_stats_engine_next_generation(engine);
+	pthread_mutex_unlock(&engine->lock);
 
-	stats = xcalloc(1, sz_stats + sizeof(struct ethtool_stats));
+	error = nl_send_auto(engine->genl_socket, msg);
+	if (error >= 0) {
+		error = nl_recvmsgs_default(engine->genl_socket);
+	}
 
-	// get stat names
-	gstrings->cmd = ETHTOOL_GSTRINGS;
-	gstrings->string_set = ETH_SS_STATS;
-	gstrings->len = n_stats;
-	ifr.ifr_data = (caddr_t) gstrings;
+	// a request for a single link is answered with the counters and an ack
+	if (error >= 0 && ifindex > 0) {
+		error = nl_wait_for_ack(engine->genl_socket);
+	}
+
+	if (error < 0) {
+		// kernels before 5.13 have the ethtool family but no statistics dump - use the ioctl from now on
+		// a single link request also fails for a link without ethtool support - only the dump decides
+		if (ifindex <= 0 && (error == -NLE_OPNOTSUPP || error == -NLE_INVAL)) {
+			engine->genl_family = 0;
+		}
 
-	if (ioctl(skfd, SIOCETHTOOL, &ifr) != 0) {
+		// values of a partial dump aren't used either
+		pthread_mutex_lock(&engine->lock);
+		nic_stats_engine_next_generation(engine);
+		pthread_mutex_unlock(&engine->lock);
 		goto error_out;
 	}
 
-	// get stat values
-	stats->cmd = ETHTOOL_GSTATS;
-	stats->n_stats = n_stats;
-	ifr.ifr_data = (caddr_t) stats;
+	error = 0;
+	goto out;
+
+error_out:
+	error = -1;
+
+out:
+	pthread_mutex_unlock(&engine->io_lock);
+
+	if (msg != NULL) {
+		nlmsg_free(msg);
+	}
+
+	return error;
+}
+#else
+// built without the statistics dump - genl_family stays 0 and every link is read with the ioctl
+int nic_stats_engine_refresh(nic_stats_engine_t *engine, int ifindex)
+{
+	return 0;
+}
+#endif
+
+int nic_stats_engine_get(nic_stats_engine_t *engine, int ifindex, const char *if_name, nic_stats_t *nic_stats)
+{
+	int error = 0;
+	nic_stats_entry_t *entry = NULL;
+	nic_stats_entry_t tmp_entry = {0};
+	unsigned int invalidations = 0;
+	bool dumped = false;
+	struct ifreq ifr = {0};
+	uint64_t counters[NIC_STATS_COUNTER_COUNT] = {0};
+
+	if (engine->skfd < 0 || ifindex <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	// set interface name
+	strncpy(&ifr.ifr_name[0], if_name, IFNAMSIZ);
+	ifr.ifr_name[IFNAMSIZ - 1] = 0;
+
+	pthread_mutex_lock(&engine->io_lock);
+
+	// the ioctls work on a copy of the entry - the table is only locked to copy it out and to store the layout back
+	pthread_mutex_lock(&engine->lock);
+
+	entry = nic_stats_engine_lookup(engine, ifindex);
+	if (entry == NULL) {
+		entry = nic_stats_engine_add(engine, ifindex);
+	}
+
+	tmp_entry = *entry;
+	invalidations = engine->invalidations;
+	// link was in the last netlink dump
+	dumped = engine->generation != 0 && entry->generation == engine->generation;
 
-	if (ioctl(skfd, SIOCETHTOOL, &ifr) != 0) {
+	pthread_mutex_unlock(&engine->lock);
+
+	entry = &tmp_entry;
+
+	if (dumped) {
+		memcpy(counters, entry->values, sizeof(counters));
+		goto fill;
+	}
+
+	if (!entry->resolved && nic_stats_engine_resolve(engine, &ifr, entry) != 0) {
 		goto error_out;
 	}
 
-	for (unsigned int i = 0; i < n_stats; i++) {
-		char *stat_name = (char *)&gstrings->data[i * ETH_GSTRING_LEN];
-		uint64_t stat_val = stats->data[i];
-
-		if (strncmp(stat_name, "rx_packets", ETH_GSTRING_LEN) == 0) {
-			nic_stats->rx_packets = stat_val;
-		} else if (strncmp(stat_name, "rx_broadcast", ETH_GSTRING_LEN) == 0) {
-			nic_stats->rx_broadcast = stat_val;
-		} else if (strncmp(stat_name, "tx_packets", ETH_GSTRING_LEN) == 0) {
-			nic_stats->tx_packets = stat_val;
-		} else if (strncmp(stat_name, "tx_broadcast", ETH_GSTRING_LEN) == 0) {
-			nic_stats->tx_broadcast = stat_val;
-		} else if (strncmp(stat_name, "tx_multicast", ETH_GSTRING_LEN) == 0) {
-			nic_stats->tx_multicast = stat_val;
+	// at most one retry - the string set is resolved again if the driver reports a different number of stats
+	for (int attempt = 0; attempt < 2; attempt++) {
+		if (entry->n_stats == 0) {
+			errno = EOPNOTSUPP;
+			goto error_out;
+		}
+
+		// get stat values
+		engine->stats->cmd = ETHTOOL_GSTATS;
+		engine->stats->n_stats = entry->n_stats;
+		ifr.ifr_data = (caddr_t) engine->stats;
+
+		if (ioctl(engine->skfd, SIOCETHTOOL, &ifr) != 0) {
+			goto error_out;
+		}
+
+		if (engine->stats->n_stats == entry->n_stats) {
+			break;
+		}
+
+		if (attempt == 1 || nic_stats_engine_resolve(engine, &ifr, entry) != 0) {
+			errno = EAGAIN;
+			goto error_out;
 		}
 	}
 
-	FREE_SAFE(gstrings);
-	FREE_SAFE(stats);
-	close(skfd);
+	for (int i = 0; i < NIC_STATS_COUNTER_COUNT; i++) {
+		if (entry->indices[i] >= 0) {
+			counters[i] = engine->stats->data[entry->indices[i]];
+		}
+	}
 
-	return 0;
+fill:
+	nic_stats->rx_packets = counters[NIC_STATS_RX_PACKETS];
+	nic_stats->rx_broadcast = counters[NIC_STATS_RX_BROADCAST];
+	nic_stats->tx_packets = counters[NIC_STATS_TX_PACKETS];
+	nic_stats->tx_broadcast = counters[NIC_STATS_TX_BROADCAST];
+	nic_stats->tx_multicast = counters[NIC_STATS_TX_MULTICAST];
+
+	goto out;
 
 error_out:
-	if (gstrings != NULL) {
-		FREE_SAFE(gstrings);
+	error = -1;
+
+out:
+	// store the layout unless the link changed meanwhile - it is resolved again on the next read then
+	if (!dumped) {
+		pthread_mutex_lock(&engine->lock);
+		if (engine->invalidations == invalidations) {
+			entry = nic_stats_engine_lookup(engine, ifindex);
+			if (entry != NULL) {
+				entry->resolved = tmp_entry.resolved;
+				entry->n_stats = tmp_entry.n_stats;
+				memcpy(entry->indices, tmp_entry.indices, sizeof(entry->indices));
+			}
+		}
+		pthread_mutex_unlock(&engine->lock);
+	}
+
+	pthread_mutex_unlock(&engine->io_lock);
+
+	return error;
+}
+
+// backward shift deletion - no tombstones are left in the table
+void nic_stats_engine_invalidate(nic_stats_engine_t *engine, int ifindex)
+{
+	unsigned int mask = 0;
+	unsigned int hole = 0;
+	unsigned int next = 0;
+
+	pthread_mutex_lock(&engine->lock);
+
+	engine->invalidations += 1;
+
+	if (engine->entries_size == 0 || ifindex <= 0) {
+		goto out;
 	}
 
-	if (stats != NULL) {
-		FREE_SAFE(stats);
+	mask = engine->entries_size - 1;
+	hole = nic_stats_engine_find_slot(engine, ifindex);
+	if (engine->entries[hole].ifindex == 0) {
+		goto out;
 	}
 
-	if (skfd >= 0) {
-		close(skfd);
+	engine->entries[hole].ifindex = 0;
+	engine->count -= 1;
+
+	next = hole;
+	while (true) {
+		next = (next + 1) & mask;
+		if (engine->entries[next].ifindex == 0) {
+			break;
+		}
+
+		const unsigned int HOME = ((uint32_t) engine->entries[next].ifindex * 2654435761u) & mask;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		engine->entries[hole] = engine->entries[next];
+		engine->entries[next].ifindex = 0;
+		hole = next;
+	}
+
+out:
+	pthread_mutex_unlock(&engine->lock);
+}
+
+void nic_stats_engine_free(nic_stats_engine_t *engine)
+{
+	if (engine->skfd >= 0) {
+		close(engine->skfd);
+		pthread_mutex_destroy(&engine->lock);
+		pthread_mutex_destroy(&engine->io_lock);
+	}
+
+	if (engine->genl_socket) {
+		nl_socket_free(engine->genl_socket);
+	}
+
+	if (engine->entries) {
+		FREE_SAFE(engine->entries);
+	}
+
+	if (engine->stats) {
+		FREE_SAFE(engine->stats);
+	}
+
+	if (engine->gstrings) {
+		FREE_SAFE(engine->gstrings);
+	}
+
+	engine->skfd = -1;
+	engine->genl_socket = NULL;
+	engine->genl_family = 0;
+	engine->entries_size = 0;
+	engine->count = 0;
+	engine->stats_capacity = 0;
+	engine->gstrings_capacity = 0;
+}
+
+#ifdef HAVE_ETHTOOL_NETLINK_STATS
+// a link is only taken from the dump if its driver reports all of the counters - the others are read with the ioctl
+static int nic_stats_engine_dump_cb(struct nl_msg *msg, void *arg)
+{
+	nic_stats_engine_t *engine = (nic_stats_engine_t *) arg;
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct nlattr *header[ETHTOOL_A_HEADER_MAX + 1];
+	struct nlattr *attr = NULL;
+	nic_stats_entry_t *entry = NULL;
+	uint64_t values[NIC_STATS_COUNTER_COUNT] = {0};
+	unsigned int found = 0;
+	int ifindex = 0;
+	int rem = 0;
+
+	nla_for_each_attr(attr, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), rem)
+	{
+		if (nla_type(attr) == ETHTOOL_A_STATS_HEADER) {
+			if (nla_parse_nested(header, ETHTOOL_A_HEADER_MAX, attr, NULL) == 0 && header[ETHTOOL_A_HEADER_DEV_INDEX] != NULL) {
+				ifindex = (int) nla_get_u32(header[ETHTOOL_A_HEADER_DEV_INDEX]);
+			}
+		} else if (nla_type(attr) == ETHTOOL_A_STATS_GRP) {
+			found |= nic_stats_engine_parse_group(attr, values);
+		}
+	}
+
+	if (ifindex <= 0 || found != (1u << NIC_STATS_COUNTER_COUNT) - 1) {
+		return NL_OK;
+	}
+
+	// called while the dump is received - the table is locked for this link only
+	pthread_mutex_lock(&engine->lock);
+
+	entry = nic_stats_engine_lookup(engine, ifindex);
+	if (entry == NULL) {
+		entry = nic_stats_engine_add(engine, ifindex);
+	}
+
+	memcpy(entry->values, values, sizeof(values));
+	entry->generation = engine->generation;
+
+	pthread_mutex_unlock(&engine->lock);
+
+	return NL_OK;
+}
+
+// returns the mask of the counters found in the group - none if it isn't the MAC statistics group
+static unsigned int nic_stats_engine_parse_group(struct nlattr *group, uint64_t values[NIC_STATS_COUNTER_COUNT])
+{
+	struct nlattr *attr = NULL;
+	struct nlattr *stat = NULL;
+	uint64_t tmp_values[NIC_STATS_COUNTER_COUNT] = {0};
+	unsigned int found = 0;
+	bool eth_mac = false;
+	int rem = 0;
+	int stat_rem = 0;
+
+	nla_for_each_nested(attr, group, rem)
+	{
+		if (nla_type(attr) == ETHTOOL_A_STATS_GRP_ID) {
+			eth_mac = nla_get_u32(attr) == ETHTOOL_STATS_ETH_MAC;
+		} else if (nla_type(attr) == ETHTOOL_A_STATS_GRP_STAT) {
+			// every counter is nested on its own - counters the driver doesn't report are left out
+			nla_for_each_nested(stat, attr, stat_rem)
+			{
+				for (int i = 0; i < NIC_STATS_COUNTER_COUNT; i++) {
+					if (nla_type(stat) == NIC_STATS_ETH_MAC_ATTRS[i]) {
+						tmp_values[i] = nla_get_u64(stat);
+						found |= 1u << i;
+					}
+				}
+			}
+		}
+	}
+
+	if (!eth_mac) {
+		return 0;
+	}
+
+	for (int i = 0; i < NIC_STATS_COUNTER_COUNT; i++) {
+		if (found & (1u << i)) {
+			values[i] = tmp_values[i];
+		}
+	}
+
+	return found;
+}
+#endif
+
+// generation 0 is never used - entries start with it and must not look fresh
+static void nic_stats_engine_next_generation(nic_stats_engine_t *engine)
+{
+	engine->generation += 1;
+	if (engine->generation == 0) {
+		engine->generation = 1;
+	}
+}
+
+static nic_stats_entry_t *nic_stats_engine_lookup(nic_stats_engine_t *engine, int ifindex)
+{
+	unsigned int slot = 0;
+
+	if (engine->entries_size == 0) {
+		return NULL;
+	}
+
+	slot = nic_stats_engine_find_slot(engine, ifindex);
+	if (engine->entries[slot].ifindex == 0) {
+		return NULL;
+	}
+
+	return &engine->entries[slot];
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static unsigned int nic_stats_engine_find_slot(nic_stats_engine_t *engine, int ifindex)
+{
+	const unsigned int MASK = engine->entries_size - 1;
+	unsigned int slot = ((uint32_t) ifindex * 2654435761u) & MASK;
+
+	while (engine->entries[slot].ifindex != 0 && engine->entries[slot].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static nic_stats_entry_t *nic_stats_engine_add(nic_stats_engine_t *engine, int ifindex)
+{
+	nic_stats_entry_t *entry = NULL;
+
+	if ((engine->count + 1) * 2 > engine->entries_size) {
+		nic_stats_engine_resize(engine, engine->entries_size ? engine->entries_size * 2 : NIC_STATS_INITIAL_SIZE);
+	}
+
+	entry = &engine->entries[nic_stats_engine_find_slot(engine, ifindex)];
+	entry->ifindex = ifindex;
+	entry->resolved = false;
+	entry->n_stats = 0;
+	entry->generation = 0;
+	engine->count += 1;
+
+	return entry;
+}
+
+static void nic_stats_engine_resize(nic_stats_engine_t *engine, unsigned int entries_size)
+{
+	nic_stats_entry_t *old_entries = engine->entries;
+	const unsigned int OLD_SIZE = engine->entries_size;
+
+	engine->entries = xcalloc(entries_size, sizeof(nic_stats_entry_t));
+	engine->entries_size = entries_size;
+
+	for (unsigned int i = 0; i < OLD_SIZE; i++) {
+		if (old_entries[i].ifindex != 0) {
+			engine->entries[nic_stats_engine_find_slot(engine, old_entries[i].ifindex)] = old_entries[i];
+		}
+	}
+
+	if (old_entries) {
+		FREE_SAFE(old_entries);
+	}
+}
+
+// look the counters up in the driver string set and remember their positions
+// a link without ethtool statistics is remembered with n_stats 0 until it is invalidated
+static int nic_stats_engine_resolve(nic_stats_engine_t *engine, struct ifreq *ifr, nic_stats_entry_t *entry)
+{
+	struct ethtool_drvinfo drvinfo = {0};
+	unsigned int n_stats = 0;
+
+	entry->resolved = true;
+	entry->n_stats = 0;
+	for (int i = 0; i < NIC_STATS_COUNTER_COUNT; i++) {
+		entry->indices[i] = -1;
+	}
+
+	// how many stats are available
+	drvinfo.cmd = ETHTOOL_GDRVINFO;
+	ifr->ifr_data = (caddr_t) &drvinfo;
+
+	if (ioctl(engine->skfd, SIOCETHTOOL, ifr) != 0) {
+		return -1;
+	}
+
+	n_stats = drvinfo.n_stats;
+	if (n_stats < 1) {
+		return 0;
+	}
+
+	if (n_stats > engine->gstrings_capacity) {
+		engine->gstrings = xrealloc(engine->gstrings, sizeof(struct ethtool_gstrings) + n_stats * ETH_GSTRING_LEN);
+		engine->gstrings_capacity = n_stats;
+	}
+
+	// get stat names
+	engine->gstrings->cmd = ETHTOOL_GSTRINGS;
+	engine->gstrings->string_set = ETH_SS_STATS;
+	engine->gstrings->len = n_stats;
+	ifr->ifr_data = (caddr_t) engine->gstrings;
+
+	if (ioctl(engine->skfd, SIOCETHTOOL, ifr) != 0) {
+		return -1;
+	}
+
+	// the kernel fills in its current count, which can differ from the one reported by GDRVINFO
+	if (engine->gstrings->len < n_stats) {
+		n_stats = engine->gstrings->len;
+	}
+
+	for (unsigned int i = 0; i < n_stats; i++) {
+		const char *stat_name = (const char *) &engine->gstrings->data[i * ETH_GSTRING_LEN];
+
+		for (int j = 0; j < NIC_STATS_COUNTER_COUNT; j++) {
+			if (entry->indices[j] == -1 && strncmp(stat_name, NIC_STATS_NAMES[j], ETH_GSTRING_LEN) == 0) {
+				entry->indices[j] = (int) i;
+				break;
+			}
+		}
+	}
+
+	nic_stats_engine_reserve_stats(engine, n_stats);
+	entry->n_stats = n_stats;
+
+	return 0;
+}
+
+// ETHTOOL_GSTATS writes as many values as the driver currently has, not as many as requested
+// keep headroom so a string set that grew since it was resolved is detected from the returned count
+// instead of writing past the buffer
+static void nic_stats_engine_reserve_stats(nic_stats_engine_t *engine, unsigned int n_stats)
+{
+	const unsigned int CAPACITY = n_stats * 2 + NIC_STATS_INITIAL_SIZE;
+
+	if (n_stats + NIC_STATS_INITIAL_SIZE <= engine->stats_capacity) {
+		return;
 	}
 
-	return -1;
+	engine->stats = xrealloc(engine->stats, sizeof(struct ethtool_stats) + CAPACITY * sizeof(uint64_t));
+	engine->stats_capacity = CAPACITY;
 }
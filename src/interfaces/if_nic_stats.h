@@ -14,9 +14,17 @@
 #ifndef IF_NIC_STATS_H_ONCE
 #define IF_NIC_STATS_H_ONCE
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <pthread.h>
 
 typedef struct nic_stats_s nic_stats_t;
+typedef struct nic_stats_entry_s nic_stats_entry_t;
+typedef struct nic_stats_engine_s nic_stats_engine_t;
+
+struct ethtool_stats;
+struct ethtool_gstrings;
+struct nl_sock;
 
 struct nic_stats_s {
 	uint64_t rx_packets;
@@ -26,6 +34,71 @@ struct nic_stats_s {
 	uint64_t tx_multicast;
 };
 
-int get_nic_stats(char *if_name, nic_stats_t *nic_stats);
+// counters of nic_stats_t in the order of their ethtool string names
+enum nic_stats_counter {
+	NIC_STATS_RX_PACKETS = 0,
+	NIC_STATS_RX_BROADCAST,
+	NIC_STATS_TX_PACKETS,
+	NIC_STATS_TX_BROADCAST,
+	NIC_STATS_TX_MULTICAST,
+	NIC_STATS_COUNTER_COUNT,
+};
+
+// per link state of the reader - entries are dropped on invalidation
+struct nic_stats_entry_s {
+	int ifindex; // 0 marks an empty slot
+
+	// layout of the driver string set - resolved once and reused until invalidated
+	bool resolved;
+	unsigned int n_stats; // 0 if the driver reports no ethtool statistics
+	int indices[NIC_STATS_COUNTER_COUNT]; // position in the GSTATS data, -1 if the driver has no such counter
+
+	// counters from the last netlink dump - used instead of the ioctl while generation matches the engine one
+	unsigned int generation;
+	uint64_t values[NIC_STATS_COUNTER_COUNT];
+};
+
+// ethtool statistics reader
+// nic_stats_engine_refresh() dumps the standard MAC statistics of all links with one ETHTOOL_MSG_STATS_GET request
+// links missing from the dump (or all links on kernels without the ethtool netlink family) are read with the ioctl:
+// one socket, the per ifindex string set layouts and the stats buffer are kept between calls
+// so that reading the counters of an already known link is a single ETHTOOL_GSTATS ioctl
+struct nic_stats_engine_s {
+	int skfd;
+
+	// lock guards the entries table and the generation and is never held across netlink or ioctl requests,
+	// so nic_stats_engine_invalidate() doesn't wait for a running read
+	// io_lock serializes the readers and guards the sockets and the request buffers
+	pthread_mutex_t lock;
+	pthread_mutex_t io_lock;
+
+	// bumped by every invalidation - a layout resolved while a link was invalidated is not stored
+	unsigned int invalidations;
+
+	// ethtool generic netlink family - genl_family is 0 if the kernel doesn't support the statistics dump
+	struct nl_sock *genl_socket;
+	int genl_family;
+	unsigned int generation;
+
+	// open addressing (linear probing) table keyed by ifindex - power of two size, kept at most half full
+	nic_stats_entry_t *entries;
+	unsigned int entries_size;
+	unsigned int count;
+
+	// reused request buffers - capacity in number of stats
+	struct ethtool_stats *stats;
+	unsigned int stats_capacity;
+	struct ethtool_gstrings *gstrings;
+	unsigned int gstrings_capacity;
+};
+
+int nic_stats_engine_init(nic_stats_engine_t *engine);
+// dump the counters of all links supporting it (or only of ifindex if not 0)
+// following nic_stats_engine_get() calls use the dumped values
+int nic_stats_engine_refresh(nic_stats_engine_t *engine, int ifindex);
+int nic_stats_engine_get(nic_stats_engine_t *engine, int ifindex, const char *if_name, nic_stats_t *nic_stats);
+// forget the cached layout of ifindex - called on link changes, the layout is resolved again on the next read
+void nic_stats_engine_invalidate(nic_stats_engine_t *engine, int ifindex);
+void nic_stats_engine_free(nic_stats_engine_t *engine);
 
 #endif /* IF_NIC_STATS_H_ONCE */
@@ -11,18 +11,39 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
+#include <string.h>
+
 #include "if_state.h"
 #include "utils/memory.h"
 #include <netlink/cache.h>
 #include <netlink/socket.h>
 
+#define IF_STATE_INDEX_INITIAL_SIZE 64
+
+static uint if_state_list_find_slot(if_state_list_t *ls, int ifindex);
+static void if_state_list_index_insert(if_state_list_t *ls, uint position);
+static void if_state_list_index_remove(if_state_list_t *ls, uint slot);
+static void if_state_list_index_resize(if_state_list_t *ls, uint index_size);
+
 void if_state_init(if_state_t *st)
 {
 	st->name = NULL;
+	st->ifindex = 0;
 	st->last_change = 0;
+	st->last_change_str[0] = '\0';
 	st->state = 0;
 }
 
+// the string is rendered once here instead of on every read
+void if_state_set_last_change(if_state_t *st, time_t last_change)
+{
+	st->last_change = last_change;
+	if (timestamp_format(last_change, st->last_change_str) != 0) {
+		st->last_change_str[0] = '\0';
+	}
+}
+
 void if_state_free(if_state_t *st)
 {
 	if (st->name != NULL) {
@@ -34,6 +55,10 @@ void if_state_list_init(if_state_list_t *ls)
 {
 	ls->data = NULL;
 	ls->count = 0;
+	ls->capacity = 0;
+	ls->index = NULL;
+	ls->index_size = 0;
+	ls->unbound_count = 0;
 }
 
 if_state_t *if_state_list_get(if_state_list_t *ls, uint idx)
@@ -54,21 +79,75 @@ if_state_t *if_state_list_get_by_if_name(if_state_list_t *ls, char *name)
 	return NULL;
 }
 
+if_state_t *if_state_list_get_by_ifindex(if_state_list_t *ls, int ifindex)
+{
+	uint slot = 0;
+
+	if (ls->index_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = if_state_list_find_slot(ls, ifindex);
+	if (ls->index[slot] == 0) {
+		return NULL;
+	}
+
+	return &ls->data[ls->index[slot] - 1];
+}
+
+// binds the state to a kernel index - a state can be bound only once
+void if_state_list_set_ifindex(if_state_list_t *ls, if_state_t *st, int ifindex)
+{
+	if (st->ifindex != 0 || ifindex <= 0 || if_state_list_get_by_ifindex(ls, ifindex) != NULL) {
+		return;
+	}
+
+	st->ifindex = ifindex;
+	ls->unbound_count -= 1;
+	if_state_list_index_insert(ls, (uint) (st - ls->data));
+}
+
+// returns the state of the interface - a state added by name only is bound to ifindex when its link is first seen
+if_state_t *if_state_list_bind(if_state_list_t *ls, int ifindex, char *name)
+{
+	if_state_t *st = if_state_list_get_by_ifindex(ls, ifindex);
+
+	// the name scan is needed only while some states are unbound
+	if (st != NULL || ls->unbound_count == 0 || name == NULL) {
+		return st;
+	}
+
+	for (uint i = 0; i < ls->count; i++) {
+		if (ls->data[i].ifindex == 0 && ls->data[i].name != NULL && strcmp(ls->data[i].name, name) == 0) {
+			if_state_list_set_ifindex(ls, &ls->data[i], ifindex);
+			return &ls->data[i];
+		}
+	}
+
+	return NULL;
+}
+
 void if_state_list_alloc(if_state_list_t *ls, uint count)
 {
 	ls->count = count;
-	ls->data = (if_state_t *) malloc(sizeof(if_state_t) * count);
+	ls->capacity = count;
+	ls->unbound_count = count;
+	ls->data = (if_state_t *) xmalloc(sizeof(if_state_t) * count);
 	for (uint i = 0; i < count; i++) {
 		if_state_init(ls->data + i);
 	}
 }
 
-void if_state_list_add(if_state_list_t *ls, uint8_t state, char *name)
+if_state_t *if_state_list_add(if_state_list_t *ls, uint8_t state, char *name)
 {
+	if (ls->count == ls->capacity) {
+		ls->capacity = ls->capacity ? ls->capacity * 2 : 8;
+		ls->data = (if_state_t *) xrealloc(ls->data, sizeof(if_state_t) * ls->capacity);
+	}
+
 	uint count = ++ls->count;
-	ls->data = (if_state_t *) realloc(ls->data, sizeof(if_state_t) * count);
 
-	ls->data[count-1].last_change = 0;
+	if_state_init(&ls->data[count-1]);
 
 	size_t len = strlen(name);
 	ls->data[count-1].name = xcalloc(len + 1, sizeof(char));
@@ -76,14 +155,123 @@ void if_state_list_add(if_state_list_t *ls, uint8_t state, char *name)
 	ls->data[count-1].name[len] = '\0';
 
 	ls->data[count-1].state = state;
+	ls->unbound_count += 1;
+
+	return &ls->data[count-1];
 }
 
-void if_state_list_free(if_state_list_t *ls)
+// the last state is moved into the freed position - pointers to it are invalidated
+void if_state_list_remove(if_state_list_t *ls, if_state_t *st)
 {
-	if (ls->count) {
-		for (uint i = 0; i < ls->count; i++) {
-			if_state_free(ls->data + i);
+	const uint POSITION = (uint) (st - ls->data);
+	const uint LAST = ls->count - 1;
+
+	if (st->ifindex > 0) {
+		if_state_list_index_remove(ls, if_state_list_find_slot(ls, st->ifindex));
+	} else {
+		ls->unbound_count -= 1;
+	}
+
+	if_state_free(st);
+
+	if (POSITION != LAST) {
+		ls->data[POSITION] = ls->data[LAST];
+		if (ls->data[POSITION].ifindex > 0) {
+			ls->index[if_state_list_find_slot(ls, ls->data[POSITION].ifindex)] = POSITION + 1;
 		}
+	}
+
+	ls->count -= 1;
+}
+
+void if_state_list_free(if_state_list_t *ls)
+{
+	for (uint i = 0; i < ls->count; i++) {
+		if_state_free(ls->data + i);
+	}
+
+	// the array can be allocated with no entries in use
+	if (ls->data) {
 		FREE_SAFE(ls->data);
 	}
+
+	if (ls->index) {
+		FREE_SAFE(ls->index);
+	}
+
+	if_state_list_init(ls);
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static uint if_state_list_find_slot(if_state_list_t *ls, int ifindex)
+{
+	const uint MASK = ls->index_size - 1;
+	// multiplicative hashing spreads consecutive indexes over the table
+	uint slot = (uint) ifindex * 2654435761u & MASK;
+
+	while (ls->index[slot] != 0 && ls->data[ls->index[slot] - 1].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void if_state_list_index_insert(if_state_list_t *ls, uint position)
+{
+	// the index is at most half full - bound states can't outnumber the list entries
+	if (ls->count * 2 > ls->index_size) {
+		if_state_list_index_resize(ls, ls->index_size ? ls->index_size * 2 : IF_STATE_INDEX_INITIAL_SIZE);
+		// resize already indexed every bound state, including this one
+		return;
+	}
+
+	ls->index[if_state_list_find_slot(ls, ls->data[position].ifindex)] = position + 1;
+}
+
+// backward shift deletion - no tombstones are left in the index
+static void if_state_list_index_remove(if_state_list_t *ls, uint slot)
+{
+	const uint MASK = ls->index_size - 1;
+	uint hole = slot;
+	uint next = slot;
+
+	ls->index[hole] = 0;
+
+	while (true) {
+		next = (next + 1) & MASK;
+		if (ls->index[next] == 0) {
+			break;
+		}
+
+		const uint HOME = (uint) ls->data[ls->index[next] - 1].ifindex * 2654435761u & MASK;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		ls->index[hole] = ls->index[next];
+		ls->index[next] = 0;
+		hole = next;
+	}
+}
+
+static void if_state_list_index_resize(if_state_list_t *ls, uint index_size)
+{
+	while (ls->count * 2 > index_size) {
+		index_size *= 2;
+	}
+
+	if (ls->index) {
+		FREE_SAFE(ls->index);
+	}
+
+	ls->index = xcalloc(index_size, sizeof(uint));
+	ls->index_size = index_size;
+
+	for (uint i = 0; i < ls->count; i++) {
+		if (ls->data[i].ifindex > 0) {
+			ls->index[if_state_list_find_slot(ls, ls->data[i].ifindex)] = i + 1;
+		}
+	}
 }
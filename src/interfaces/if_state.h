@@ -17,29 +17,47 @@
 #include <stdint.h>
 #include <time.h>
 
+#include "timestamp.h"
+
 typedef struct if_state_s if_state_t;
 typedef struct if_state_list_s if_state_list_t;
 typedef unsigned int uint;
 
 struct if_state_s {
 	char *name;
+	int ifindex; // 0 until the kernel index of the interface is known
 	uint8_t state;
 	time_t last_change;
+	char last_change_str[TIMESTAMP_BUF_SIZE]; // last_change rendered when it is set, empty while unknown
 };
 
 void if_state_init(if_state_t *st);
+void if_state_set_last_change(if_state_t *st, time_t last_change);
 void if_state_free(if_state_t *st);
 
 struct if_state_list_s {
 	if_state_t *data;
 	uint count;
+	uint capacity;
+
+	// open addressing (linear probing) index by ifindex - position + 1 of the state in data, 0 marks an empty slot
+	// power of two size, kept at most half full
+	uint *index;
+	uint index_size;
+
+	// states not bound to an index yet (added by name only)
+	uint unbound_count;
 };
 
 void if_state_list_init(if_state_list_t *ls);
 if_state_t *if_state_list_get(if_state_list_t *ls, uint idx);
 if_state_t *if_state_list_get_by_if_name(if_state_list_t *ls, char *name);
+if_state_t *if_state_list_get_by_ifindex(if_state_list_t *ls, int ifindex);
+void if_state_list_set_ifindex(if_state_list_t *ls, if_state_t *st, int ifindex);
+if_state_t *if_state_list_bind(if_state_list_t *ls, int ifindex, char *name);
 void if_state_list_alloc(if_state_list_t *ls, uint count);
-void if_state_list_add(if_state_list_t *ls, uint8_t state, char *name);
+if_state_t *if_state_list_add(if_state_list_t *ls, uint8_t state, char *name);
+void if_state_list_remove(if_state_list_t *ls, if_state_t *st);
 void if_state_list_free(if_state_list_t *ls);
 
 #endif /* IF_STATE_H_ONCE */
@@ -14,16 +14,20 @@
 #include <arpa/inet.h>
 #include <dirent.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
-#include <sys/sysinfo.h>
 #include <sys/types.h>
-#include <linux/if.h>
+#include <net/if.h>
 #include <linux/if.h>
 #include <linux/if_addr.h>
 #include <linux/ip.h>
@@ -40,8 +44,6 @@
 #include <netlink/route/link/inet6.h>
 #include <netlink/route/link/vlan.h>
 #include <netlink/route/neighbour.h>
-#include <netlink/route/qdisc.h>
-#include <netlink/route/tc.h>
 #include <netlink/socket.h>
 
 #include <libyang/libyang.h>
@@ -53,10 +55,16 @@
 #include "if_state.h"
 #include "ip_data.h"
 #include "link_data.h"
+#include "link_layers.h"
+#include "link_snapshot.h"
+#include "link_stats.h"
+#include "stats_sampler.h"
+#include "timestamp.h"
 #include "utils/memory.h"
 
 #define BASE_YANG_MODEL "ietf-interfaces"
 #define BASE_IP_YANG_MODEL "ietf-ip"
+#define RATES_YANG_MODEL "sysrepo-plugin-interfaces-rates"
 
 // config data
 #define INTERFACES_YANG_MODEL "/" BASE_YANG_MODEL ":interfaces"
@@ -65,15 +73,25 @@
 // other #defines
 #define MAC_ADDR_MAX_LENGTH 18
 #define MAX_DESCR_LEN 100
-#define DATETIME_BUF_SIZE 30
-#define CLASS_NET_LINE_LEN 1024
 #define ADDR_STR_BUF_SIZE 45 // max ip string length (15 for ipv4 and 45 for ipv6)
 #define MAX_IF_NAME_LEN IFNAMSIZ // 16 bytes
 #define CMD_LEN 1024
 
+// statistics sampling period in milliseconds - 0 collects the counters on every operational request instead
+#define STATS_INTERVAL_ENV "INTERFACES_PLUGIN_STATS_INTERVAL"
+#define STATS_INTERVAL_DEFAULT_MS 1000
+
+// comma separated averaging windows of the rate estimates in seconds - empty disables the estimates
+#define RATE_WINDOWS_ENV "INTERFACES_PLUGIN_RATE_WINDOWS"
+#define RATE_WINDOWS_DEFAULT "10,60,300"
+
 // callbacks
 static int interfaces_module_change_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *xpath, sr_event_t event, uint32_t request_id, void *private_data);
 static int interfaces_state_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
+static int interfaces_layers_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
+static int interfaces_ip_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
+static int interfaces_statistics_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
+static int interfaces_rates_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
 
 // helper functions
 static bool system_running_datastore_is_empty_check(sr_session_ctx_t *session);
@@ -90,29 +108,76 @@ int write_to_proc_file(const char *dir_path, char *interface, const char *fn, in
 static int read_from_proc_file(const char *dir_path, char *interface, const char *fn, int *val);
 static int read_from_sys_file(const char *dir_path, char *interface, int *val);
 int delete_config_value(const char *xpath, const char *value);
-int update_link_info(link_data_list_t *ld, sr_change_oper_t operation);
+int update_link_info(link_data_list_t *ld, struct nl_cache *links, sr_change_oper_t operation);
 static char *convert_ianaiftype(char *iana_if_type);
-int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld);
+int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld, const link_snapshot_t *snapshot);
 static int get_interface_description(sr_session_ctx_t *session, char *name, char **description);
 static int create_vlan_qinq(char *name, char *parent_interface, uint16_t outer_vlan_id, uint16_t second_vlan_id);
-static int get_system_boot_time(char boot_datetime[]);
-
-// function to start all threads for each interface
-static int init_state_changes(void);
-
-// callback function for a thread to track state changes on a specific interface (ifindex passed using void* data param)
+static int get_link_speed(const char *name, uint64_t *speed);
+static int get_link_mtu(const char *name, unsigned int *mtu);
+static int get_lower_link(struct rtnl_link *link);
+static void update_link_layers(struct rtnl_link *link);
+static void add_layer_if(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *xpath, int ifindex);
+
+// operational data
+static bool parse_oper_request(const char *request_xpath, char *if_name);
+static int get_parent_interface(struct lyd_node *parent, const char **name, int *ifindex);
+static int add_interface_state(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, struct rtnl_link *link, const char *system_boot_time);
+static int add_interface_layers(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, int ifindex, bool higher);
+static int add_interface_ip(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, const char *name, unsigned int mtu, int addr_ver);
+static int add_interface_statistics(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, const link_stats_t *tmp_stats, const char *system_boot_time);
+
+// link manager and interface state tracking
+static int init_link_manager(void);
+static int init_state_changes(const link_snapshot_t *snapshot);
+static void free_plugin_data(void);
+
+// statistics
+static int init_stats_sampler(void);
+static int parse_rate_windows(const char *str, unsigned int *windows, unsigned int *count);
+static int collect_link_stats(link_stats_list_t *ls, void *arg);
+static int collect_single_link_stats(link_stats_list_t *ls, struct nl_sock *socket, int ifindex, const char *name);
+
+// link manager thread - blocks until link events arrive or manager_wakeup_fd is signaled on cleanup
 static void *manager_thread_cb(void *data);
 static void cache_change_cb(struct nl_cache *cache, struct nl_object *obj, int val, void *arg);
 
-// static list of interface states for tracking state changes using threads
+// static list of interface states for tracking state changes - entries follow link additions and removals
+// written by the link manager thread, guarded by if_state_changes_lock
 static if_state_list_t if_state_changes;
+static pthread_mutex_t if_state_changes_lock = PTHREAD_MUTEX_INITIALIZER;
 
 // global list of link_data structs
 static link_data_list_t link_data_list = {0};
 
 // link manager used for cacheing links info constantly
+// link_cache is changed by the manager thread with link_cache_lock write locked - readers take the read lock
 static struct nl_cache_mngr *link_manager = NULL;
 static struct nl_cache *link_cache = NULL;
+static pthread_rwlock_t link_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_t manager_thread;
+static int manager_wakeup_fd = -1;
+
+// higher/lower-layer-if index - built from link_cache and updated by cache_change_cb, guarded by link_cache_lock
+static link_layers_t link_layers = {0};
+
+// boot time string - refreshed by the manager thread when the realtime clock is set
+static timestamp_cache_t timestamp_cache = {.timer_fd = -1};
+
+// ethtool statistics reader - string set layouts are invalidated by cache_change_cb
+static nic_stats_engine_t nic_stats_engine = {.skfd = -1};
+
+// background statistics snapshots - not running if sampling is disabled
+// stats_socket is used by the sampler thread, or by the statistics callback under request_stats_lock without sampling
+static stats_sampler_t stats_sampler = {.lock = PTHREAD_RWLOCK_INITIALIZER, .timer_fd = -1, .wakeup_fd = -1};
+static struct nl_sock *stats_socket = NULL;
+
+// counters collected by the statistics callback if sampling is disabled
+// the callback is called for every interface of a request - the counters are collected once per request_id
+static link_stats_list_t request_stats = {0};
+static uint32_t request_stats_id = 0;
+static bool request_stats_valid = false;
+static pthread_mutex_t request_stats_lock = PTHREAD_MUTEX_INITIALIZER;
 
 volatile int exit_application = 0;
 
@@ -123,16 +188,47 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 	sr_session_ctx_t *startup_session = NULL;
 	sr_subscription_ctx_t *subscription = NULL;
 	char *desc_file_path = NULL;
+	struct nl_sock *snapshot_socket = NULL;
+	link_snapshot_t snapshot;
 
 	*private_data = NULL;
 
+	link_snapshot_init(&snapshot);
+
 	error = link_data_list_init(&link_data_list);
 	if (error != 0) {
 		SRP_LOG_ERR("link_data_list_init error");
 		goto out;
 	}
 
-	error = add_existing_links(session, &link_data_list);
+	// the link manager dump is the only link dump at startup - every init stage reads the snapshot taken from it
+	error = init_link_manager();
+	if (error != 0) {
+		SRP_LOG_ERR("init_link_manager error");
+		goto out;
+	}
+
+	snapshot_socket = nl_socket_alloc();
+	if (snapshot_socket == NULL) {
+		SRP_LOG_ERR("nl_socket_alloc error: invalid socket");
+		error = -1;
+		goto out;
+	}
+
+	error = nl_connect(snapshot_socket, NETLINK_ROUTE);
+	if (error != 0) {
+		SRP_LOG_ERR("nl_connect error (%d): %s", error, nl_geterror(error));
+		goto out;
+	}
+
+	// the manager thread isn't running yet - link_cache can be read without the lock
+	error = link_snapshot_load(&snapshot, snapshot_socket, link_cache);
+	if (error != 0) {
+		SRP_LOG_ERR("link_snapshot_load error (%d): %s", error, nl_geterror(error));
+		goto out;
+	}
+
+	error = add_existing_links(session, &link_data_list, &snapshot);
 	if (error != 0) {
 		SRP_LOG_ERR("add_existing_links error");
 		goto out;
@@ -142,12 +238,32 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 
 	if_state_list_init(&if_state_changes);
 
-	error = init_state_changes();
+	// polled by the manager thread - initialized before it is started
+	error = timestamp_cache_init(&timestamp_cache);
+	if (error != 0) {
+		SRP_LOG_ERR("timestamp_cache_init error: %s", strerror(errno));
+		goto out;
+	}
+
+	error = nic_stats_engine_init(&nic_stats_engine);
+	if (error != 0) {
+		SRP_LOG_ERR("nic_stats_engine_init error: %s", strerror(errno));
+		goto out;
+	}
+
+	error = init_state_changes(&snapshot);
 	if (error != 0) {
 		SRP_LOG_ERR("Error occurred while initializing threads to track interface changes... exiting");
 		goto out;
 	}
 
+	// uses the link cache - started after the link manager
+	error = init_stats_sampler();
+	if (error != 0) {
+		SRP_LOG_ERR("init_stats_sampler error");
+		goto out;
+	}
+
 	connection = sr_session_get_connection(session);
 	error = sr_session_start(connection, SR_DS_STARTUP, &startup_session);
 	if (error) {
@@ -181,7 +297,7 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 	}
 
 	// apply what is present in the startup datastore
-	error = update_link_info(&link_data_list, SR_OP_CREATED);
+	error = update_link_info(&link_data_list, snapshot.links, SR_OP_CREATED);
 	if (error != 0) {
 		SRP_LOG_ERR("update_link_info error");
 		goto error_out;
@@ -196,12 +312,57 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 		goto error_out;
 	}
 
+	// one provider per subtree - the nested ones are called for each interface entry created by interfaces_state_data_cb
+	// and only if the request selects their subtree, so reading the link state doesn't collect counters or addresses
 	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, INTERFACES_YANG_MODEL "/*", interfaces_state_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
 	if (error) {
 		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
 		goto error_out;
 	}
 
+	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/higher-layer-if", interfaces_layers_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/lower-layer-if", interfaces_layers_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	error = sr_oper_get_items_subscribe(session, BASE_IP_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/" BASE_IP_YANG_MODEL ":ipv4", interfaces_ip_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	error = sr_oper_get_items_subscribe(session, BASE_IP_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/" BASE_IP_YANG_MODEL ":ipv6", interfaces_ip_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/statistics", interfaces_statistics_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	// rate estimates need the sampler and the plugin augment module
+	if (stats_sampler.running && stats_sampler.rate_window_count > 0) {
+		if (ly_ctx_get_module_implemented(sr_get_context(connection), RATES_YANG_MODEL) == NULL) {
+			SRP_LOG_INF("%s module not installed - rate estimates not provided", RATES_YANG_MODEL);
+		} else {
+			error = sr_oper_get_items_subscribe(session, RATES_YANG_MODEL, INTERFACE_LIST_YANG_PATH "/statistics/" RATES_YANG_MODEL ":rate", interfaces_rates_data_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+			if (error) {
+				SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+				goto error_out;
+			}
+		}
+	}
+
 	SRP_LOG_INF("plugin init done");
 
 	FREE_SAFE(desc_file_path);
@@ -209,14 +370,28 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 	goto out;
 
 error_out:
+	// the callbacks use the plugin data - unsubscribe before it is freed
 	if (subscription != NULL) {
 		sr_unsubscribe(subscription);
 	}
 
+	if (startup_session != NULL) {
+		sr_session_stop(startup_session);
+		*private_data = NULL;
+	}
+
 	if (desc_file_path != NULL) {
 		FREE_SAFE(desc_file_path);
 	}
 out:
+	link_snapshot_free(&snapshot);
+	nl_socket_free(snapshot_socket);
+
+	// the cleanup callback isn't called after a failed init - nothing may be left running
+	if (error != 0) {
+		free_plugin_data();
+	}
+
 	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
 }
 
@@ -249,7 +424,7 @@ static int load_data(sr_session_ctx_t *session, link_data_list_t *ld)
 	char xpath_buffer[PATH_MAX] = {0};
 	char tmp_buffer[PATH_MAX] = {0};
 
-	for (int i = 0; i < ld->count; i++) {
+	for (uint32_t i = 0; i < ld->count; i++) {
 		char *name = ld->links[i].name;
 		char *type = ld->links[i].type;
 		char *description = ld->links[i].description;
@@ -647,17 +822,47 @@ void sr_plugin_cleanup_cb(sr_session_ctx_t *session, void *private_data)
 	// copy the running datastore to startup one, in case we reboot
 	sr_copy_config(startup_session, BASE_YANG_MODEL, SR_DS_RUNNING, 0);
 
-	exit_application = 1;
-
 	if (startup_session) {
 		sr_session_stop(startup_session);
 	}
 
+	free_plugin_data();
+
+	SRP_LOG_INF("plugin cleanup finished");
+}
+
+// stops the manager and sampler threads and frees the data they use
+// called on cleanup and on a failed init - safe with any of the parts not initialized
+static void free_plugin_data(void)
+{
+	exit_application = 1;
+
+	// wake the manager thread up and wait for it before freeing the data it uses
+	if (manager_wakeup_fd != -1) {
+		if (eventfd_write(manager_wakeup_fd, 1) == 0) {
+			pthread_join(manager_thread, NULL);
+		}
+		close(manager_wakeup_fd);
+		manager_wakeup_fd = -1;
+	}
+
+	timestamp_cache_free(&timestamp_cache);
+
+	// the sampler reads the link cache and the ethtool engine - stop it before they are freed
+	stats_sampler_stop(&stats_sampler);
+	if (stats_socket != NULL) {
+		nl_socket_free(stats_socket);
+		stats_socket = NULL;
+	}
+
+	link_stats_list_free(&request_stats);
 	link_data_list_free(&link_data_list);
 	if_state_list_free(&if_state_changes);
 	nl_cache_mngr_free(link_manager);
-
-	SRP_LOG_INF("plugin cleanup finished");
+	link_manager = NULL;
+	link_cache = NULL;
+	link_layers_free(&link_layers);
+	nic_stats_engine_free(&nic_stats_engine);
 }
 
 static int interfaces_module_change_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *xpath, sr_event_t event, uint32_t request_id, void *private_data)
@@ -739,7 +944,7 @@ static int interfaces_module_change_cb(sr_session_ctx_t *session, uint32_t subsc
 			FREE_SAFE(node_value);
 		}
 
-		error = update_link_info(&link_data_list, operation);
+		error = update_link_info(&link_data_list, NULL, operation);
 		if (error) {
 			error = SR_ERR_CALLBACK_FAILED;
 			SRP_LOG_ERR("update_link_info error");
@@ -1119,10 +1324,11 @@ out:
 	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
 }
 
-int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
+// links is the startup snapshot during plugin init - NULL dumps the current links
+int update_link_info(link_data_list_t *ld, struct nl_cache *links, sr_change_oper_t operation)
 {
 	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
+	struct nl_cache *cache = links;
 	struct rtnl_link *old = NULL;
 	struct rtnl_link *old_vlan_qinq = NULL;
 	struct rtnl_link *request = NULL;
@@ -1140,13 +1346,15 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 		goto out;
 	}
 
-	error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-	if (error != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-		goto out;
+	if (cache == NULL) {
+		error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
+		if (error != 0) {
+			SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
+			goto out;
+		}
 	}
 
-	for (int i = 0; i < ld->count; i++) {
+	for (uint32_t i = 0; i < ld->count; i++) {
 		char *name = ld->links[i].name;
 		char *type = ld->links[i].type;
 		char *enabled = ld->links[i].enabled;
@@ -1183,10 +1391,8 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 				goto out;
 			}
 
-			// free the link from link_data_list
-			link_data_free(&ld->links[i]);
-			// set delete to false
-			ld->links[i].delete = false;
+			// free the link from link_data_list - the position stays as a hole
+			link_data_list_remove(ld, name);
 
 			// cleanup
 			if (old != NULL) {
@@ -1259,13 +1465,8 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 			if (strcmp(type, "vlan") == 0) {
 				// if second vlan id is present treat it as QinQ vlan
 				if (second_vlan_id != 0) {
-					// update the last-change state list
-					uint8_t state = rtnl_link_get_operstate(request);
-
-					if_state_list_add(&if_state_changes, state, second_vlan_name);
-					if_state_list_add(&if_state_changes, state, name);
-
-					// then create the interface with new parameters
+					// create the interface with new parameters
+					// last-change state entries of the new links are added by the link manager
 					create_vlan_qinq(name, parent_interface, outer_vlan_id, second_vlan_id);
 
 				} else if (second_vlan_id == 0) {
@@ -1304,6 +1505,8 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 		}
 
 		if (old != NULL) {
+			link_data_list_set_ifindex(ld, name, rtnl_link_get_ifindex(old));
+
 			// add ipv4/ipv6 options
 			error = add_interface_ipv4(&ld->links[i], old, request, rtnl_link_get_ifindex(old));
 			if (error != 0) {
@@ -1344,10 +1547,7 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 
 			// don't create if it's a QinQ vlan interface since it's already been created
 			if (second_vlan_id == 0) {
-				// update the last-change state list
-				uint8_t state = rtnl_link_get_operstate(request);
-
-				if_state_list_add(&if_state_changes, state, name);
+				// the last-change state entry of the new link is added by the link manager
 
 				// set the new name
 				rtnl_link_set_name(request, name);
@@ -1364,17 +1564,26 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 			// in order to add ipv4/ipv6 options we first have to create the interface
 			// and then get its interface index, because we need it inside add_interface_ipv4/ipv6
 			// and don't want to set it manually...
-			nl_cache_free(cache);
-			error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-			if (error != 0) {
-				SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-				goto out;
+			// only the new links are requested - the cache isn't dumped again, they are added to it
+			// so that links created later in this loop find them (e.g. a vlan on a new parent)
+			if (old_vlan_qinq != NULL) {
+				rtnl_link_put(old_vlan_qinq);
+				old_vlan_qinq = NULL;
 			}
 
-			old = rtnl_link_get_by_name(cache, name);
-			old_vlan_qinq = rtnl_link_get_by_name(cache, second_vlan_name);
+			if (rtnl_link_get_kernel(socket, 0, name, &old) != 0) {
+				old = NULL;
+			} else {
+				nl_cache_add(cache, (struct nl_object *) old);
+			}
+
+			if (second_vlan_name[0] != '\0' && rtnl_link_get_kernel(socket, 0, second_vlan_name, &old_vlan_qinq) != 0) {
+				old_vlan_qinq = NULL;
+			}
 
 			if (old != NULL) {
+				link_data_list_set_ifindex(ld, name, rtnl_link_get_ifindex(old));
+
 				error = add_interface_ipv4(&ld->links[i], old, request, rtnl_link_get_ifindex(old));
 				if (error != 0) {
 					SRP_LOG_ERR("add_interface_ipv4 error");
@@ -1421,7 +1630,11 @@ int update_link_info(link_data_list_t *ld, sr_change_oper_t operation)
 
 out:
 	nl_socket_free(socket);
-	nl_cache_free(cache);
+
+	// the snapshot cache is owned by the caller
+	if (cache != links) {
+		nl_cache_free(cache);
+	}
 
 	return error;
 }
@@ -1485,7 +1698,6 @@ int add_interface_ipv4(link_data_t *ld, struct rtnl_link *old, struct rtnl_link
 	struct rtnl_addr *r_addr = NULL;
 	struct rtnl_neigh *neigh = NULL;
 	struct nl_addr *ll_addr = NULL;
-	struct nl_cache *cache = NULL;
 
 	// add ipv4 options from given link data to the req link object
 	// also set forwarding options to the given files for a particular link
@@ -1580,25 +1792,8 @@ int add_interface_ipv4(link_data_t *ld, struct rtnl_link *old, struct rtnl_link
 		rtnl_neigh_set_lladdr(neigh, ll_addr);
 		rtnl_neigh_set_dst(neigh, local_addr);
 
-		error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-		if (error != 0) {
-			SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-			nl_addr_put(ll_addr);
-			nl_addr_put(local_addr);
-			rtnl_neigh_put(neigh);
-			goto out;
-		}
-
-		struct rtnl_neigh *tmp_neigh = rtnl_neigh_get(cache, if_idx, local_addr);
-		int neigh_oper = NLM_F_CREATE;
-
-		if (tmp_neigh != NULL) {
-			// if the neighbor already exists, replace it
-			// otherwise create it (NLM_F_CREATE)
-			neigh_oper = NLM_F_REPLACE;
-		}
-
-		error = rtnl_neigh_add(socket, neigh, neigh_oper);
+		// replace the neighbor if it already exists, otherwise create it - no need to look it up first
+		error = rtnl_neigh_add(socket, neigh, NLM_F_CREATE | NLM_F_REPLACE);
 		if (error != 0) {
 			SRP_LOG_ERR("rtnl_neigh_add error (%d): %s", error, nl_geterror(error));
 			nl_addr_put(ll_addr);
@@ -1677,7 +1872,6 @@ int add_interface_ipv6(link_data_t *ld, struct rtnl_link *old, struct rtnl_link
 	struct rtnl_addr *r_addr = NULL;
 	struct rtnl_neigh *neigh = NULL;
 	struct nl_addr *ll_addr = NULL;
-	struct nl_cache *cache = NULL;
 
 	// enabled
 	error = write_to_proc_file(ipv6_base, if_name, "disable_ipv6", ipv6->ip_data.enabled == 0);
@@ -1777,25 +1971,8 @@ int add_interface_ipv6(link_data_t *ld, struct rtnl_link *old, struct rtnl_link
 		rtnl_neigh_set_lladdr(neigh, ll_addr);
 		rtnl_neigh_set_dst(neigh, local_addr);
 
-		error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-		if (error != 0) {
-			SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-			nl_addr_put(ll_addr);
-			nl_addr_put(local_addr);
-			rtnl_neigh_put(neigh);
-			goto out;
-		}
-
-		struct rtnl_neigh *tmp_neigh = rtnl_neigh_get(cache, if_idx, local_addr);
-		int neigh_oper = NLM_F_CREATE;
-
-		if (tmp_neigh != NULL) {
-			// if the neighbor already exists, replace it
-			// otherwise create it (NLM_F_CREATE)
-			neigh_oper = NLM_F_REPLACE;
-		}
-
-		error = rtnl_neigh_add(socket, neigh, neigh_oper);
+		// replace the neighbor if it already exists, otherwise create it - no need to look it up first
+		error = rtnl_neigh_add(socket, neigh, NLM_F_CREATE | NLM_F_REPLACE);
 		if (error != 0) {
 			SRP_LOG_ERR("rtnl_neigh_add error (%d): %s", error, nl_geterror(error));
 			nl_addr_put(ll_addr);
@@ -1889,95 +2066,41 @@ static int create_vlan_qinq(char *name, char *parent_interface, uint16_t outer_v
 	return 0;
 }
 
+// system (non-virtual) interfaces are the ones whose /sys/class/net entry doesn't point into /sys/devices/virtual
+// only the entry of the checked interface is read - the check doesn't depend on the number of interfaces
 static bool check_system_interface(const char *interface_name, bool *system_interface)
 {
 	int error = 0;
-	char *all_devices_cmd = "ls /sys/class/net";
-	char *check_system_devices_cmd = "ls -l /sys/class/net";
-	char line[CLASS_NET_LINE_LEN] = {0};
-	int all_cnt = 0;
-	int sys_cnt = 0;
-	char *all_interfaces[LD_MAX_LINKS] = {0};
-	char *system_interfaces[LD_MAX_LINKS] = {0};
-	FILE *system_interface_check = NULL;
-
-	system_interface_check = popen(all_devices_cmd, "r");
-	if (system_interface_check == NULL) {
-		SRP_LOG_WRN("could not execute %s", all_devices_cmd);
-		*system_interface = false;
-		error = -1;
-		goto out;
-	}
-
-	// get all interfaces from /sys/class/net
-	while (fgets(line, sizeof(line), system_interface_check) != NULL) {
-		// remove newline char from line
-		line[strlen(line) - 1] = '\0';
-		all_interfaces[all_cnt] = strndup(line, strlen(line) + 1);
-		all_cnt++;
-	}
+	char path_buffer[PATH_MAX] = {0};
+	char link_buffer[PATH_MAX] = {0};
+	ssize_t len = 0;
 
-	pclose(system_interface_check);
-	// reset everything to reuse it
-	system_interface_check = NULL;
-	memset(line, 0, CLASS_NET_LINE_LEN);
+	*system_interface = false;
 
-	system_interface_check = popen(check_system_devices_cmd, "r");
-	if (system_interface_check == NULL) {
-		SRP_LOG_WRN("could not execute %s", check_system_devices_cmd);
-		*system_interface = false;
-		error = -1;
+	// loopback device is virtual but handle it as a physical device here
+	// because libnl won't let us delete it
+	if (strcmp(interface_name, "lo") == 0) {
+		*system_interface = true;
 		goto out;
 	}
 
-	// check if an interface is virtual or system
-	while (fgets(line, sizeof(line), system_interface_check) != NULL) {
-		// loopback device is virtual but handle it as a physical device here
-		// because libnl won't let us delete it
-		if (strstr(line, "/lo") != NULL ||
-			(strstr(line, "/virtual/") == NULL &&
-			 strncmp(line, "total", strlen("total") != 0))) {
-			// this is a system interface
-
-			// add it to system_interfaces
-			for (int i = 0; i < LD_MAX_LINKS; i++) {
-				if (all_interfaces[i] != 0) {
-					if (strstr(line, all_interfaces[i]) != NULL) {
-						system_interfaces[sys_cnt] = strndup(all_interfaces[i], strlen(all_interfaces[i]) + 1);
-						sys_cnt++;
-						break;
-					}
-				}
-			}
-		}
-		memset(line, 0, CLASS_NET_LINE_LEN);
+	error = snprintf(path_buffer, sizeof(path_buffer), "/sys/class/net/%s", interface_name);
+	if (error < 0) {
+		SRP_LOG_WRN("snprintf error");
+		goto out;
 	}
+	error = 0;
 
-	for (int i = 0; i < LD_MAX_LINKS; i++) {
-		if (system_interfaces[i] != 0) {
-			if (strcmp(interface_name, system_interfaces[i]) == 0) {
-				*system_interface = true;
-				break;
-			}
-		}
+	len = readlink(path_buffer, link_buffer, sizeof(link_buffer) - 1);
+	if (len < 0) {
+		// no entry - the interface doesn't exist (yet)
+		goto out;
 	}
+	link_buffer[len] = 0;
 
-	// cleanup
-	for (int i = 0; i < LD_MAX_LINKS; i++) {
-		if (system_interfaces[i] != 0) {
-			FREE_SAFE(system_interfaces[i]);
-		}
-
-		if (all_interfaces[i] != 0) {
-			FREE_SAFE(all_interfaces[i]);
-		}
-	}
+	*system_interface = strstr(link_buffer, "/virtual/") == NULL;
 
 out:
-	if (system_interface_check) {
-		pclose(system_interface_check);
-	}
-
 	return error;
 }
 
@@ -2086,14 +2209,13 @@ out:
 	return error;
 }
 
-int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
+// links, addresses and neighbors are read from the startup snapshot - the kernel tables aren't dumped here
+int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld, const link_snapshot_t *snapshot)
 {
 	int error = 0;
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
 	struct rtnl_link *link = NULL;
-	struct nl_cache *addr_cache = NULL;
-	struct nl_cache *neigh_cache = NULL;
+	const link_snapshot_entry_t *entry = NULL;
+	const link_snapshot_entry_t *parent_entry = NULL;
 	struct rtnl_addr *addr = {0};
 	char *name = NULL;
 	char *description = NULL;
@@ -2109,25 +2231,7 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 	char dst_addr_str[ADDR_STR_BUF_SIZE];
 	char ll_addr_str[ADDR_STR_BUF_SIZE];
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("nl_socket_alloc error: invalid socket");
-		goto error_out;
-	}
-
-	error = nl_connect(socket, NETLINK_ROUTE);
-	if (error != 0) {
-		SRP_LOG_ERR("nl_connect error (%d): %s", error, nl_geterror(error));
-		goto error_out;
-	}
-
-	error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-	if (error != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-		goto error_out;
-	}
-
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	link = (struct rtnl_link *) nl_cache_get_first(snapshot->links);
 
 	while (link != NULL) {
 		name = rtnl_link_get_name(link);
@@ -2187,8 +2291,13 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 		// vlan
 		if (rtnl_link_is_vlan(link)) {
 			// parent interface
-			int parent_index = rtnl_link_get_link(link);
-			parent_interface = rtnl_link_i2name(cache, parent_index, parent_buffer, MAX_IF_NAME_LEN);
+			parent_entry = link_snapshot_get(snapshot, rtnl_link_get_link(link));
+			if (parent_entry != NULL) {
+				snprintf(parent_buffer, sizeof(parent_buffer), "%s", rtnl_link_get_name(parent_entry->link));
+				parent_interface = parent_buffer;
+			} else {
+				parent_interface = NULL;
+			}
 
 			// outer vlan id
 			vlan_id = (uint16_t)rtnl_link_vlan_get_id(link);
@@ -2216,6 +2325,12 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 			goto error_out;
 		}
 
+		error = link_data_list_set_ifindex(ld, name, rtnl_link_get_ifindex(link));
+		if (error != 0) {
+			SRP_LOG_ERR("link_data_list_set_ifindex error");
+			goto error_out;
+		}
+
 		if (description != NULL) {
 			error = link_data_list_set_description(ld, name, description);
 			if (error != 0) {
@@ -2256,107 +2371,59 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 
 		int if_index = rtnl_link_get_ifindex(link);
 
-		// neighbors
-		error = rtnl_neigh_alloc_cache(socket, &neigh_cache);
-		if (error != 0) {
-			SRP_LOG_ERR("rtnl_neigh_alloc_cache error (%d): %s", error, nl_geterror(error));
-			goto error_out;
-		}
-
-		int neigh_count = nl_cache_nitems(neigh_cache);
+		entry = link_snapshot_get(snapshot, if_index);
 
-		struct nl_object *nl_neigh_object;
-		nl_neigh_object = nl_cache_get_first(neigh_cache);
+		// neighbors
+		for (unsigned int i = 0; entry != NULL && i < entry->neighs.count; i++) {
+			struct rtnl_neigh *neigh = (struct rtnl_neigh *) entry->neighs.data[i];
 
-		for (int i=0; i < neigh_count; i++) {
-			struct nl_addr *nl_dst_addr = rtnl_neigh_get_dst((struct rtnl_neigh *) nl_neigh_object);
+			// skip neighs with no arp state
+			if (NUD_NOARP == rtnl_neigh_get_state(neigh)) {
+				continue;
+			}
 
-			char *dst_addr = nl_addr2str(nl_dst_addr, dst_addr_str, sizeof(dst_addr_str));
+			char *dst_addr = nl_addr2str(rtnl_neigh_get_dst(neigh), dst_addr_str, sizeof(dst_addr_str));
 			if (dst_addr == NULL) {
 				SRP_LOG_ERR("nl_addr2str error");
 				goto error_out;
 			}
 
-			struct rtnl_neigh *neigh = rtnl_neigh_get(neigh_cache, if_index, nl_dst_addr);
-
-			if (neigh != NULL) {
-				// get neigh state
-				int neigh_state = rtnl_neigh_get_state(neigh);
-
-				// skip neighs with no arp state
-				if (NUD_NOARP == neigh_state) {
-					nl_neigh_object = nl_cache_get_next(nl_neigh_object);
-					continue;
-				}
-
-				int cur_neigh_index = rtnl_neigh_get_ifindex(neigh);
+			struct nl_addr *ll_addr = rtnl_neigh_get_lladdr(neigh);
 
-				if (if_index != cur_neigh_index) {
-					nl_neigh_object = nl_cache_get_next(nl_neigh_object);
-					continue;
-				}
+			char *ll_addr_s = nl_addr2str(ll_addr, ll_addr_str, sizeof(ll_addr_str));
+			if (NULL == ll_addr_s) {
+				SRP_LOG_ERR("nl_addr2str error");
+				goto error_out;
+			}
 
-				struct nl_addr *ll_addr = rtnl_neigh_get_lladdr(neigh);
+			// check if ipv4 or ipv6
+			addr_family = rtnl_neigh_get_family(neigh);
 
-				char *ll_addr_s = nl_addr2str(ll_addr, ll_addr_str, sizeof(ll_addr_str));
-				if (NULL == ll_addr_s) {
-					SRP_LOG_ERR("nl_addr2str error");
+			if (addr_family == AF_INET) {
+				error = link_data_list_add_ipv4_neighbor(&link_data_list, name, dst_addr, ll_addr_s);
+				if (error != 0) {
+					SRP_LOG_ERR("link_data_list_add_ipv4_neighbor error (%d) : %s", error, strerror(error));
 					goto error_out;
 				}
-
-				// check if ipv4 or ipv6
-				addr_family = rtnl_neigh_get_family(neigh);
-
-				if (addr_family == AF_INET) {
-					error = link_data_list_add_ipv4_neighbor(&link_data_list, name, dst_addr, ll_addr_s);
-					if (error != 0) {
-						SRP_LOG_ERR("link_data_list_add_ipv4_neighbor error (%d) : %s", error, strerror(error));
-						goto error_out;
-					}
-				} else if (addr_family == AF_INET6) {
-					error = link_data_list_add_ipv6_neighbor(&link_data_list, name, dst_addr, ll_addr_s);
-					if (error != 0) {
-						SRP_LOG_ERR("link_data_list_add_ipv6_neighbor error (%d) : %s", error, strerror(error));
-						goto error_out;
-					}
+			} else if (addr_family == AF_INET6) {
+				error = link_data_list_add_ipv6_neighbor(&link_data_list, name, dst_addr, ll_addr_s);
+				if (error != 0) {
+					SRP_LOG_ERR("link_data_list_add_ipv6_neighbor error (%d) : %s", error, strerror(error));
+					goto error_out;
 				}
-				rtnl_neigh_put(neigh);
 			}
-			nl_neigh_object = nl_cache_get_next(nl_neigh_object);
-		}
-
-		nl_cache_free(neigh_cache);
-		neigh_cache = NULL;
-
-		error = rtnl_addr_alloc_cache(socket, &addr_cache);
-		if (error != 0) {
-			SRP_LOG_ERR("rtnl_addr_alloc_cache error (%d): %s", error, nl_geterror(error));
-			goto error_out;
 		}
 
 		// get ipv4 and ipv6 addresses
-		int addr_count = nl_cache_nitems(addr_cache);
-
-		struct nl_object *nl_object;
-		nl_object = nl_cache_get_first(addr_cache);
-
-		addr = (struct rtnl_addr *) nl_object;
+		for (unsigned int i = 0; entry != NULL && i < entry->addrs.count; i++) {
+			addr = (struct rtnl_addr *) entry->addrs.data[i];
 
-		for (int i=0; i < addr_count; i++) {
 			struct nl_addr *nl_addr_local = rtnl_addr_get_local(addr);
 			if (nl_addr_local == NULL) {
 				SRP_LOG_ERR("rtnl_addr_get_local error");
 				goto error_out;
 			}
 
-			int cur_if_index = rtnl_addr_get_ifindex(addr);
-
-			if (if_index != cur_if_index) {
-				nl_object = nl_cache_get_next(nl_object);
-				addr = (struct rtnl_addr *) nl_object;
-				continue;
-			}
-
 			const char*addr_s = nl_addr2str(nl_addr_local, addr_str, sizeof(addr_str));
 			if (NULL == addr_s) {
 				SRP_LOG_ERR("nl_addr2str error");
@@ -2512,15 +2579,10 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 				}
 			}
 
-			nl_object = nl_cache_get_next(nl_object);
-			addr = (struct rtnl_addr *) nl_object;
-
 			FREE_SAFE(str);
 			FREE_SAFE(address);
 			FREE_SAFE(subnet);
 		}
-		nl_cache_free(addr_cache);
-		addr_cache = NULL;
 
 		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
 
@@ -2529,28 +2591,9 @@ int add_existing_links(sr_session_ctx_t *session, link_data_list_t *ld)
 		}
 	}
 
-	rtnl_link_put(link);
-
-	nl_socket_free(socket);
-	nl_cache_free(cache);
-
 	return 0;
 
 error_out:
-	if (socket != NULL) {
-		nl_socket_free(socket);
-	}
-
-	if (link != NULL) {
-		rtnl_link_put(link);
-	}
-
-	nl_cache_free(cache);
-
-	if (addr_cache != NULL) {
-		nl_cache_free(addr_cache);
-	}
-
 	if (description != NULL) {
 		FREE_SAFE(description);
 	}
@@ -2589,812 +2632,1028 @@ error_out:
 	return -1;
 }
 
+// interface list entries and their leaves - the other subtrees have their own providers
 static int interfaces_state_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
 {
 	int error = SR_ERR_OK;
 	const struct ly_ctx *ly_ctx = NULL;
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
 	struct rtnl_link *link = NULL;
-	struct nl_addr *addr = NULL;
-	struct rtnl_tc *tc = NULL;
-	struct rtnl_qdisc *qdisc = NULL;
-
-	int32_t tmp_if_index = 0;
-	uint64_t tmp_len = 0;
-	struct rtnl_link *tmp_link = NULL;
+	struct rtnl_link *single_link = NULL;
 
-	char tmp_buffer[PATH_MAX] = {0};
 	char xpath_buffer[PATH_MAX] = {0};
 	char interface_path_buffer[PATH_MAX] = {0};
+	char if_name[IFNAMSIZ] = {0};
+	char if_index[12] = {0};
+	char system_boot_time[TIMESTAMP_BUF_SIZE] = {0};
+	bool state_requested = false;
+	bool cache_locked = false;
 
-	if_state_t *tmp_ifs = NULL;
+	if (*parent == NULL) {
+		ly_ctx = sr_get_context(sr_session_get_connection(session));
+		if (ly_ctx == NULL) {
+			error = SR_ERR_CALLBACK_FAILED;
+			goto error_out;
+		}
+		lyd_new_path(*parent, ly_ctx, request_xpath, NULL, 0, NULL);
+	}
 
-	unsigned int mtu = 0;
+	// only the requested interface is created - the entries are still needed as parents if only a subtree is requested
+	state_requested = parse_oper_request(request_xpath, if_name);
 
-	struct {
-		char *name;
-		char *description;
-		char *type;
-		char *enabled;
-		char *link_up_down_trap_enable;
-		char *admin_status;
-		const char *oper_status;
-		struct tm *last_change;
-		int32_t if_index;
-		char *phys_address;
-		struct {
-			char *masters[LD_MAX_LINKS];
-			uint32_t count;
-		} higher_layer_if;
-		uint64_t speed;
-		struct {
-			char *discontinuity_time;
-			uint64_t in_octets;
-			uint64_t in_unicast_pkts;
-			uint64_t in_broadcast_pkts;
-			uint64_t in_multicast_pkts;
-			uint32_t in_discards;
-			uint32_t in_errors;
-			uint32_t in_unknown_protos;
-			uint64_t out_octets;
-			uint64_t out_unicast_pkts;
-			uint64_t out_broadcast_pkts;
-			uint64_t out_multicast_pkts;
-			uint32_t out_discards;
-			uint32_t out_errors;
-		} statistics;
-	} interface_data = {0};
+	// rendered once per request - the same for every interface
+	timestamp_cache_get_boot_time(&timestamp_cache, system_boot_time);
 
-	typedef struct {
-		char *slave_name;
-		char *master_names[LD_MAX_LINKS];
-		uint32_t count;
-	} master_t;
+	pthread_rwlock_rdlock(&link_cache_lock);
+	cache_locked = true;
 
-	typedef struct {
-		master_t masters[LD_MAX_LINKS];
-		uint32_t count;
-	} master_list_t;
+	// a single interface is looked up in the manager cache - no kernel request per operational request
+	if (if_name[0] != '\0') {
+		single_link = rtnl_link_get_by_name(link_cache, if_name);
+		if (single_link == NULL) {
+			SRP_LOG_DBG("interface %s not found", if_name);
+			goto out;
+		}
+	}
 
-	master_list_t master_list = {0};
+	link = single_link != NULL ? single_link : (struct rtnl_link *) nl_cache_get_first(link_cache);
+	while (link != NULL) {
+		snprintf(interface_path_buffer, sizeof(interface_path_buffer) / sizeof(char), "%s[name=\"%s\"]", INTERFACE_LIST_YANG_PATH, rtnl_link_get_name(link));
 
-	typedef struct {
-		char *master_name;
-		char *slave_names[LD_MAX_LINKS];
-		uint32_t count;
-	} slave_t;
+		if (state_requested) {
+			if (add_interface_state(*parent, ly_ctx, interface_path_buffer, link, system_boot_time) != 0) {
+				goto error_out;
+			}
+		} else {
+			error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/name", interface_path_buffer);
+			if (error < 0) {
+				goto error_out;
+			}
+			lyd_new_path(*parent, ly_ctx, xpath_buffer, rtnl_link_get_name(link), LYD_ANYDATA_STRING, 0);
 
-	typedef struct {
-		slave_t slaves[LD_MAX_LINKS];
-		uint32_t count;
-	} slave_list_t;
+			// read back by the nested providers instead of resolving the name again
+			error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/if-index", interface_path_buffer);
+			if (error < 0) {
+				goto error_out;
+			}
+			snprintf(if_index, sizeof(if_index), "%d", rtnl_link_get_ifindex(link));
+			lyd_new_path(*parent, ly_ctx, xpath_buffer, if_index, LYD_ANYDATA_STRING, 0);
+		}
 
-	slave_list_t slave_list = {0};
+		// continue to next link node - a single requested link has none
+		link = single_link != NULL ? NULL : (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	}
 
-	const char *OPER_STRING_MAP[] = {
-		[IF_OPER_UNKNOWN] = "unknown",
-		[IF_OPER_NOTPRESENT] = "not-present",
-		[IF_OPER_DOWN] = "down",
-		[IF_OPER_LOWERLAYERDOWN] = "lower-layer-down",
-		[IF_OPER_TESTING] = "testing",
-		[IF_OPER_DORMANT] = "dormant",
-		[IF_OPER_UP] = "up",
-	};
+	error = SR_ERR_OK; // set error to OK, since it will be modified by snprintf
 
-	if (*parent == NULL) {
-		ly_ctx = sr_get_context(sr_session_get_connection(session));
-		if (ly_ctx == NULL) {
-			error = SR_ERR_CALLBACK_FAILED;
-			goto error_out;
-		}
-		lyd_new_path(*parent, ly_ctx, request_xpath, NULL, 0, NULL);
+	goto out;
+
+error_out:
+	error = SR_ERR_CALLBACK_FAILED;
+
+out:
+	// the reference belongs to a cache object - dropped before the manager may free it
+	if (single_link != NULL) {
+		rtnl_link_put(single_link);
 	}
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("nl_socket_alloc error: invalid socket");
-		goto error_out;
+	if (cache_locked) {
+		pthread_rwlock_unlock(&link_cache_lock);
 	}
 
-	if ((error = nl_connect(socket, NETLINK_ROUTE)) != 0) {
-		SRP_LOG_ERR("nl_connect error (%d): %s", error, nl_geterror(error));
-		goto error_out;
+	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
+}
+
+// called once per interface entry for each of the two leaf-lists
+static int interfaces_layers_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = 0;
+	const char *name = NULL;
+	int ifindex = 0;
+	char interface_path_buffer[PATH_MAX] = {0};
+
+	const bool HIGHER = strcmp(path, INTERFACE_LIST_YANG_PATH "/higher-layer-if") == 0;
+
+	if (get_parent_interface(*parent, &name, &ifindex) != 0) {
+		return SR_ERR_OK;
 	}
 
-	error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-	if (error != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-		goto error_out;
+	snprintf(interface_path_buffer, sizeof(interface_path_buffer), "%s[name=\"%s\"]", INTERFACE_LIST_YANG_PATH, name);
+
+	// the layer index is guarded by the link cache lock
+	pthread_rwlock_rdlock(&link_cache_lock);
+	error = add_interface_layers(*parent, NULL, interface_path_buffer, ifindex, HIGHER);
+	pthread_rwlock_unlock(&link_cache_lock);
+
+	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
+}
+
+// called once per interface entry for each of the ietf-ip containers
+static int interfaces_ip_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = 0;
+	const char *name = NULL;
+	int ifindex = 0;
+	unsigned int mtu = 0;
+	char interface_path_buffer[PATH_MAX] = {0};
+
+	const int ADDR_VER = strcmp(path, INTERFACE_LIST_YANG_PATH "/" BASE_IP_YANG_MODEL ":ipv4") == 0 ? 4 : 6;
+
+	if (get_parent_interface(*parent, &name, &ifindex) != 0) {
+		return SR_ERR_OK;
 	}
 
-	// collect all master interfaces
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	snprintf(interface_path_buffer, sizeof(interface_path_buffer), "%s[name=\"%s\"]", INTERFACE_LIST_YANG_PATH, name);
 
-	while (link != NULL) {
-		char *slave_name = rtnl_link_get_name(link);
+	// mtu is left out if unknown
+	if (get_link_mtu(name, &mtu) != 0) {
+		mtu = 0;
+	}
 
-		// higher-layer-if
-		tmp_if_index = rtnl_link_get_master(link);
-		while (tmp_if_index) {
-			tmp_link = rtnl_link_get(cache, tmp_if_index);
+	error = add_interface_ip(*parent, NULL, interface_path_buffer, name, mtu, ADDR_VER);
 
-			char *master_name = rtnl_link_get_name(tmp_link);
+	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
+}
 
-			tmp_len = strlen(master_name);
+// called once per interface entry - counters come from the sampler snapshot or are collected once per request
+static int interfaces_statistics_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = 0;
+	const char *name = NULL;
+	int ifindex = 0;
+	char interface_path_buffer[PATH_MAX] = {0};
+	char if_name[IFNAMSIZ] = {0};
+	char system_boot_time[TIMESTAMP_BUF_SIZE] = {0};
 
-			interface_data.higher_layer_if.masters[interface_data.higher_layer_if.count] = xstrndup(master_name, tmp_len);
+	const link_stats_t *tmp_stats = NULL;
+	const link_stats_t NO_STATS = {0};
 
-			interface_data.higher_layer_if.count++;
+	if (get_parent_interface(*parent, &name, &ifindex) != 0) {
+		return SR_ERR_OK;
+	}
 
-			tmp_if_index = rtnl_link_get_master(tmp_link);
-		}
+	snprintf(interface_path_buffer, sizeof(interface_path_buffer), "%s[name=\"%s\"]", INTERFACE_LIST_YANG_PATH, name);
+	timestamp_cache_get_boot_time(&timestamp_cache, system_boot_time);
 
-		if (interface_data.higher_layer_if.count > 0) {
-			for (uint64_t i = 0; i < interface_data.higher_layer_if.count; i++) {
-				char *master_name = interface_data.higher_layer_if.masters[i];
+	if (stats_sampler.running) {
+		tmp_stats = link_stats_list_get(stats_sampler_acquire(&stats_sampler), ifindex);
+		error = add_interface_statistics(*parent, NULL, interface_path_buffer, tmp_stats != NULL ? tmp_stats : &NO_STATS, system_boot_time);
+		stats_sampler_release(&stats_sampler);
 
-				tmp_len = strlen(slave_name);
-				master_list.masters[master_list.count].slave_name = xstrndup(slave_name, tmp_len);
+		return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
+	}
 
-				tmp_len = strlen(master_name);
-				master_list.masters[master_list.count].master_names[i] = xstrndup(master_name, tmp_len);
-			}
+	pthread_mutex_lock(&request_stats_lock);
 
-			master_list.masters[master_list.count].count = interface_data.higher_layer_if.count;
-			master_list.count++;
+	// all links are collected with one dump - a request for a single interface only reads that one
+	if (!request_stats_valid || request_stats_id != request_id) {
+		parse_oper_request(request_xpath, if_name);
+		if (if_name[0] != '\0') {
+			error = collect_single_link_stats(&request_stats, stats_socket, ifindex, name);
+		} else {
+			error = collect_link_stats(&request_stats, stats_socket);
 		}
 
-		// continue to next link node
-		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+		request_stats_id = request_id;
+		request_stats_valid = error == 0;
+		if (error != 0) {
+			goto error_out;
+		}
 	}
 
-	// collect all slave interfaces
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	// a link created after the counters were collected has none yet
+	tmp_stats = link_stats_list_get(&request_stats, ifindex);
+	error = add_interface_statistics(*parent, NULL, interface_path_buffer, tmp_stats != NULL ? tmp_stats : &NO_STATS, system_boot_time);
+	if (error != 0) {
+		goto error_out;
+	}
 
-	while (link != NULL) {
-		// lower-layer-if
-		char *if_name = rtnl_link_get_name(link);
-
-		bool break_out = false;
-		for (uint64_t i = 0; i < master_list.count; i++) {
-			for (uint64_t j = 0; j < master_list.masters[i].count; j++) {
-				if (strcmp(master_list.masters[i].slave_name, master_list.masters[i].master_names[j]) == 0) {
-					continue;
-				}
+	goto out;
 
-				if (strcmp(master_list.masters[i].master_names[j], if_name) == 0) {
-					SRP_LOG_DBG("Slave of interface %s: %s", if_name, master_list.masters[i].slave_name);
+error_out:
+	error = -1;
 
-					tmp_len = strlen(if_name);
-					slave_list.slaves[slave_list.count].master_name = xstrndup(if_name, tmp_len);
+out:
+	pthread_mutex_unlock(&request_stats_lock);
 
-					tmp_len = strlen(master_list.masters[i].slave_name);
-					slave_list.slaves[slave_list.count].slave_names[i] = xstrndup(master_list.masters[i].slave_name, tmp_len);
+	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
+}
 
-					slave_list.slaves[slave_list.count].count++;
+// interface name selected by request_xpath - if_name is left empty if all interfaces are requested
+// returns false if only a subtree served by a nested provider is requested, i.e. the leaves of the entry aren't needed
+// only simple paths are narrowed down, anything else (unions, other predicates ...) gets all the data
+static bool parse_oper_request(const char *request_xpath, char *if_name)
+{
+	const size_t LIST_PATH_LEN = strlen(INTERFACE_LIST_YANG_PATH);
+	const char *ptr = NULL;
+	const char *end = NULL;
+	char quote = 0;
+
+	// subtrees served by the nested providers
+	const char *NESTED_NODES[] = {
+		"statistics",
+		"higher-layer-if",
+		"lower-layer-if",
+		BASE_IP_YANG_MODEL ":ipv4",
+		BASE_IP_YANG_MODEL ":ipv6",
+	};
 
-					break_out = true;
-					break;
-				}
-			}
-			if (break_out) {
-				slave_list.count++;
-				break;
-			}
-		}
-		// continue to next link node
-		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	if_name[0] = '\0';
+
+	if (request_xpath == NULL || strchr(request_xpath, '|') != NULL || strstr(request_xpath, "//") != NULL) {
+		return true;
 	}
 
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
-	qdisc = rtnl_qdisc_alloc();
+	if (strncmp(request_xpath, INTERFACE_LIST_YANG_PATH, LIST_PATH_LEN) != 0) {
+		return true;
+	}
 
-	while (link != NULL) {
-		// get tc and set the link
-		tc = TC_CAST(qdisc);
-		rtnl_tc_set_link(tc, link);
+	ptr = request_xpath + LIST_PATH_LEN;
 
-		interface_data.name = rtnl_link_get_name(link);
+	// interface[name='eth0'] or interface[name="eth0"]
+	if (*ptr == '[') {
+		if (strncmp(ptr, "[name=", 6) != 0 || (ptr[6] != '\'' && ptr[6] != '"')) {
+			return true;
+		}
 
-		link_data_t *l = data_list_get_by_name(&link_data_list, interface_data.name);
-		interface_data.description = l->description;
+		quote = ptr[6];
+		ptr += 7;
+		end = strchr(ptr, quote);
+		if (end == NULL || end[1] != ']' || end == ptr || end - ptr >= IFNAMSIZ) {
+			return true;
+		}
 
-		interface_data.type = rtnl_link_get_type(link);
-		interface_data.enabled = rtnl_link_get_operstate(link) == IF_OPER_UP ? "enabled" : "disabled";
-		// interface_data.link_up_down_trap_enable = ?
-		// interface_data.admin_status = ?
-		interface_data.oper_status = OPER_STRING_MAP[rtnl_link_get_operstate(link)];
-		interface_data.if_index = rtnl_link_get_ifindex(link);
+		memcpy(if_name, ptr, (size_t) (end - ptr));
+		if_name[end - ptr] = '\0';
+		ptr = end + 2;
+	}
 
-		// last-change field
-		tmp_ifs = if_state_list_get_by_if_name(&if_state_changes, interface_data.name);
-		interface_data.last_change = (tmp_ifs->last_change != 0) ? localtime(&tmp_ifs->last_change) : NULL;
+	// the whole entry
+	if (*ptr == '\0') {
+		return true;
+	}
 
-		// get_system_boot_time will change the struct tm which is held in interface_data.last_change if it's not NULL
-		char system_time[DATETIME_BUF_SIZE] = {0};
-		if (interface_data.last_change != NULL) {
-			// convert it to human readable format here
-			strftime(system_time, sizeof system_time, "%FT%TZ", interface_data.last_change);
+	// more predicates or not the interface list at all
+	if (*ptr != '/') {
+		if_name[0] = '\0';
+		return true;
+	}
+	ptr += 1;
+
+	// the first node below the entry selects the subtree - any other node (or *) needs the leaves of the entry
+	for (size_t i = 0; i < sizeof(NESTED_NODES) / sizeof(NESTED_NODES[0]); i++) {
+		const size_t LEN = strlen(NESTED_NODES[i]);
+		if (strncmp(ptr, NESTED_NODES[i], LEN) == 0 && (ptr[LEN] == '\0' || ptr[LEN] == '/' || ptr[LEN] == '[')) {
+			return false;
 		}
+	}
 
-		// mac address
-		addr = rtnl_link_get_addr(link);
-		interface_data.phys_address = xmalloc(sizeof(char) * (MAC_ADDR_MAX_LENGTH + 1));
-		nl_addr2str(addr, interface_data.phys_address, MAC_ADDR_MAX_LENGTH);
-		interface_data.phys_address[MAC_ADDR_MAX_LENGTH] = 0;
+	return true;
+}
 
-		interface_data.speed = rtnl_tc_get_stat(tc, RTNL_TC_RATE_BPS);
+// name and ifindex of the interface entry a nested provider is called for
+// interfaces_state_data_cb creates both leaves from the link cache - no kernel lookup per entry and provider
+static int get_parent_interface(struct lyd_node *parent, const char **name, int *ifindex)
+{
+	struct lyd_node *name_node = NULL;
+	struct lyd_node *index_node = NULL;
 
-		// stats:
-		char system_boot_time[DATETIME_BUF_SIZE] = {0};
-		error = get_system_boot_time(system_boot_time);
-		if (error != 0) {
-			SRP_LOG_ERR("get_system_boot_time error: %s", strerror(errno));
-			goto error_out;
-		}
-		interface_data.statistics.discontinuity_time = system_boot_time;
+	if (parent == NULL || lyd_find_path(parent, "name", false, &name_node) != LY_SUCCESS || lyd_find_path(parent, "if-index", false, &index_node) != LY_SUCCESS) {
+		return -1;
+	}
 
-		// gather interface statistics that are not accessable via netlink
-		nic_stats_t nic_stats = {0};
-		error = get_nic_stats(interface_data.name, &nic_stats);
-		if (error != 0) {
-			SRP_LOG_ERR("get_nic_stats error: %s", strerror(errno));
-		}
+	*name = lyd_get_value(name_node);
+	*ifindex = (int) strtol(lyd_get_value(index_node), NULL, 10);
 
-		// Rx
-		interface_data.statistics.in_octets = rtnl_link_get_stat(link, RTNL_LINK_RX_BYTES);
-		interface_data.statistics.in_broadcast_pkts = nic_stats.rx_broadcast;
-		interface_data.statistics.in_multicast_pkts = rtnl_link_get_stat(link, RTNL_LINK_MULTICAST);
-		interface_data.statistics.in_unicast_pkts = nic_stats.rx_packets - nic_stats.rx_broadcast - interface_data.statistics.in_multicast_pkts;
+	return *ifindex > 0 ? 0 : -1;
+}
 
-		interface_data.statistics.in_discards = (uint32_t) rtnl_link_get_stat(link, RTNL_LINK_RX_DROPPED);
-		interface_data.statistics.in_errors = (uint32_t) rtnl_link_get_stat(link, RTNL_LINK_RX_ERRORS);
-		interface_data.statistics.in_unknown_protos = (uint32_t) rtnl_link_get_stat(link, RTNL_LINK_IP6_INUNKNOWNPROTOS);
+// leaves of the interface list entry
+static int add_interface_state(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, struct rtnl_link *link, const char *system_boot_time)
+{
+	int error = 0;
+	struct nl_addr *addr = NULL;
+	link_data_t *l = NULL;
+	if_state_t *tmp_ifs = NULL;
+	char last_change[TIMESTAMP_BUF_SIZE] = {0};
 
-		// Tx
-		interface_data.statistics.out_octets = rtnl_link_get_stat(link, RTNL_LINK_TX_BYTES);
-		interface_data.statistics.out_broadcast_pkts = nic_stats.tx_broadcast;
-		interface_data.statistics.out_multicast_pkts = nic_stats.tx_multicast;
-		interface_data.statistics.out_unicast_pkts = nic_stats.tx_packets - nic_stats.tx_broadcast - nic_stats.tx_multicast;
+	char tmp_buffer[PATH_MAX] = {0};
+	char xpath_buffer[PATH_MAX] = {0};
 
-		interface_data.statistics.out_discards = (uint32_t) rtnl_link_get_stat(link, RTNL_LINK_TX_DROPPED);
-		interface_data.statistics.out_errors = (uint32_t) rtnl_link_get_stat(link, RTNL_LINK_TX_ERRORS);
+	struct {
+		char *name;
+		char *description;
+		char *type;
+		char *enabled;
+		char *link_up_down_trap_enable;
+		char *admin_status;
+		const char *oper_status;
+		const char *last_change;
+		int32_t if_index;
+		char *phys_address;
+		uint64_t speed;
+	} interface_data = {0};
 
-		snprintf(interface_path_buffer, sizeof(interface_path_buffer) / sizeof(char), "%s[name=\"%s\"]", INTERFACE_LIST_YANG_PATH, rtnl_link_get_name(link));
+	const char *OPER_STRING_MAP[] = {
+		[IF_OPER_UNKNOWN] = "unknown",
+		[IF_OPER_NOTPRESENT] = "not-present",
+		[IF_OPER_DOWN] = "down",
+		[IF_OPER_LOWERLAYERDOWN] = "lower-layer-down",
+		[IF_OPER_TESTING] = "testing",
+		[IF_OPER_DORMANT] = "dormant",
+		[IF_OPER_UP] = "up",
+	};
 
-		// name
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/name", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.name);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, interface_data.name, LYD_ANYDATA_STRING, 0);
+	interface_data.name = rtnl_link_get_name(link);
 
-		// description
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/description", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.description);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, interface_data.description, LYD_ANYDATA_STRING, 0);
+	// links created outside of the plugin have no link data
+	l = data_list_get_by_name(&link_data_list, interface_data.name);
+	interface_data.description = l != NULL ? l->description : NULL;
 
-		// type
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/type", interface_path_buffer);
+	interface_data.type = rtnl_link_get_type(link);
+	interface_data.enabled = rtnl_link_get_operstate(link) == IF_OPER_UP ? "enabled" : "disabled";
+	// interface_data.link_up_down_trap_enable = ?
+	// interface_data.admin_status = ?
+	interface_data.oper_status = OPER_STRING_MAP[rtnl_link_get_operstate(link)];
+	interface_data.if_index = rtnl_link_get_ifindex(link);
+
+	// last-change field - copied out, the entry can move once the lock is released
+	pthread_mutex_lock(&if_state_changes_lock);
+	tmp_ifs = if_state_list_bind(&if_state_changes, interface_data.if_index, interface_data.name);
+	if (tmp_ifs != NULL) {
+		memcpy(last_change, tmp_ifs->last_change_str, sizeof(last_change));
+	} else {
+		last_change[0] = '\0';
+	}
+	pthread_mutex_unlock(&if_state_changes_lock);
+
+	interface_data.last_change = last_change[0] != '\0' ? last_change : NULL;
+
+	// mac address
+	addr = rtnl_link_get_addr(link);
+	interface_data.phys_address = xmalloc(sizeof(char) * (MAC_ADDR_MAX_LENGTH + 1));
+	nl_addr2str(addr, interface_data.phys_address, MAC_ADDR_MAX_LENGTH);
+	interface_data.phys_address[MAC_ADDR_MAX_LENGTH] = 0;
+
+	// nominal speed - traffic rates are provided by interfaces_rates_data_cb
+	const bool SPEED_KNOWN = get_link_speed(interface_data.name, &interface_data.speed) == 0;
+
+	// name
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/name", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.name);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, interface_data.name, LYD_ANYDATA_STRING, 0);
+
+	// description
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/description", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.description);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, interface_data.description, LYD_ANYDATA_STRING, 0);
+
+	// type
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/type", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.type);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, interface_data.type, LYD_ANYDATA_STRING, 0);
+
+	// oper-status
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/oper-status", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.oper_status);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, (char *) interface_data.oper_status, LYD_ANYDATA_STRING, 0);
+
+	// last-change -> only if changed at one point
+	if (interface_data.last_change != NULL) {
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/last-change", interface_path_buffer);
 		if (error < 0) {
 			goto error_out;
 		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.type);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, interface_data.type, LYD_ANYDATA_STRING, 0);
-
-		// oper-status
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/oper-status", interface_path_buffer);
+		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.last_change);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, (char *) interface_data.last_change, LYD_ANYDATA_STRING, 0);
+	} else {
+		// default value of last-change should be system boot time
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/last-change", interface_path_buffer);
 		if (error < 0) {
 			goto error_out;
 		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.oper_status);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, (char *) interface_data.oper_status, LYD_ANYDATA_STRING, 0);
+		SRP_LOG_DBG("%s = %s", xpath_buffer, system_boot_time);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, system_boot_time, LYD_ANYDATA_STRING, 0);
+	}
 
-		// last-change -> only if changed at one point
-		if (interface_data.last_change != NULL) {
-			error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/last-change", interface_path_buffer);
-			if (error < 0) {
-				goto error_out;
-			}
-			SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.type);
-			lyd_new_path(*parent, ly_ctx, xpath_buffer, system_time, LYD_ANYDATA_STRING, 0);
-		} else {
-			// default value of last-change should be system boot time
-			error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/last-change", interface_path_buffer);
-			if (error < 0) {
-				goto error_out;
-			}
-			SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.type);
-			lyd_new_path(*parent, ly_ctx, xpath_buffer, system_boot_time, LYD_ANYDATA_STRING, 0);
-		}
+	// if-index
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/if-index", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %d", xpath_buffer, interface_data.if_index);
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.if_index);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// if-index
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/if-index", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		SRP_LOG_DBG("%s = %d", xpath_buffer, interface_data.if_index);
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.if_index);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// phys-address
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/phys-address", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.phys_address);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, interface_data.phys_address, LYD_ANYDATA_STRING, 0);
 
-		// phys-address
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/phys-address", interface_path_buffer);
+	// speed
+	if (SPEED_KNOWN) {
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/speed", interface_path_buffer);
 		if (error < 0) {
 			goto error_out;
 		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.phys_address);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, interface_data.phys_address, LYD_ANYDATA_STRING, 0);
+		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.speed);
+		SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	}
 
-		// speed
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/speed", interface_path_buffer);
+	error = 0;
+	goto out;
+
+error_out:
+	error = -1;
+
+out:
+	if (interface_data.phys_address) {
+		FREE_SAFE(interface_data.phys_address);
+	}
+
+	return error;
+}
+
+// higher-layer-if or lower-layer-if - the master and stacked links are above, the lower link and members below
+// link_cache_lock has to be held by the caller
+static int add_interface_layers(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, int ifindex, bool higher)
+{
+	int error = 0;
+	const link_layer_node_t *tmp_layers = NULL;
+	const link_layer_edges_t *edges = NULL;
+	char xpath_buffer[PATH_MAX] = {0};
+
+	tmp_layers = link_layers_get(&link_layers, ifindex);
+	if (tmp_layers == NULL) {
+		return 0;
+	}
+
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/%s", interface_path_buffer, higher ? "higher-layer-if" : "lower-layer-if");
+	if (error < 0) {
+		goto error_out;
+	}
+
+	add_layer_if(parent, ly_ctx, xpath_buffer, higher ? tmp_layers->master : tmp_layers->link);
+
+	edges = higher ? &tmp_layers->stacked : &tmp_layers->members;
+	for (unsigned int i = 0; i < edges->count; i++) {
+		add_layer_if(parent, ly_ctx, xpath_buffer, edges->data[i]);
+	}
+
+	return 0;
+
+error_out:
+	return -1;
+}
+
+// ietf-ip ipv4 (addr_ver 4) or ipv6 container - links created outside of the plugin have none
+static int add_interface_ip(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, const char *name, unsigned int mtu, int addr_ver)
+{
+	int error = 0;
+	link_data_t *l = data_list_get_by_name(&link_data_list, (char *) name);
+
+	char tmp_buffer[PATH_MAX] = {0};
+	char xpath_buffer[PATH_MAX] = {0};
+
+	// list of ipv4 addresses
+	if (l != NULL && addr_ver == 4) {
+		// enabled
+		// TODO
+
+		// forwarding
+		uint8_t ipv4_forwarding = l->ipv4.forwarding;
+
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/forwarding", interface_path_buffer);
 		if (error < 0) {
 			goto error_out;
 		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.speed);
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.speed);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// higher-layer-if
-		for (uint64_t i = 0; i < master_list.count; i++) {
-			if (strcmp(interface_data.name, master_list.masters[i].slave_name) == 0) {
-				for (uint64_t j = 0; j < master_list.masters[i].count; j++) {
+		SRP_LOG_DBG("%s = %d", xpath_buffer, ipv4_forwarding);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, ipv4_forwarding == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
+
+		uint32_t ipv4_addr_count = l->ipv4.addr_list.count;
+
+		for (uint32_t j = 0; j < ipv4_addr_count; j++) {
+			if (l->ipv4.addr_list.addr[j].ip != NULL) { // in case we deleted an ip address it will be NULL
+				char *ip_addr = l->ipv4.addr_list.addr[j].ip;
 
-					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/higher-layer-if", interface_path_buffer);
+				if (mtu > 0) {
+					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/mtu", interface_path_buffer);
 					if (error < 0) {
 						goto error_out;
 					}
+					snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", mtu);
+					SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+					lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+				}
+
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/address[ip='%s']/ip", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
+				}
+				// ip
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv4.addr_list.addr[j].ip);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv4.addr_list.addr[j].ip, LYD_ANYDATA_STRING, 0);
 
-					SRP_LOG_DBG("%s += %s", xpath_buffer, master_list.masters[i].master_names[j]);
-					lyd_new_path(*parent, ly_ctx, xpath_buffer, master_list.masters[i].master_names[j], LYD_ANYDATA_STRING, 0);
+				// subnet
+				snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", l->ipv4.addr_list.addr[j].subnet);
 
-					FREE_SAFE(interface_data.higher_layer_if.masters[i]);
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/address[ip='%s']/prefix-length", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
 				}
+
+				SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 			}
 		}
 
-		// lower-layer-if
-		for (uint64_t i = 0; i < slave_list.count; i++) {
-			if (strcmp(interface_data.name, slave_list.slaves[i].master_name) == 0) {
-				for (uint64_t j = 0; j < slave_list.slaves[i].count; j++) {
+		// neighbors
+		uint32_t ipv4_neigh_count = l->ipv4.nbor_list.count;
 
-					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/lower-layer-if", interface_path_buffer);
-					if (error < 0) {
-						goto error_out;
-					}
+		for (uint32_t j = 0; j < ipv4_neigh_count; j++) {
+			if (l->ipv4.nbor_list.nbor[j].ip != NULL) { // in case we deleted an ip address it will be NULL
+				char *ip_addr = l->ipv4.nbor_list.nbor[j].ip;
 
-					SRP_LOG_DBG("%s += %s", xpath_buffer, slave_list.slaves[i].slave_names[j]);
-					lyd_new_path(*parent, ly_ctx, xpath_buffer, slave_list.slaves[i].slave_names[j], LYD_ANYDATA_STRING, 0);
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/neighbor[ip='%s']/ip", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
 				}
+				// ip
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv4.nbor_list.nbor[j].ip);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv4.nbor_list.nbor[j].ip, LYD_ANYDATA_STRING, 0);
+
+				// link-layer-address
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/neighbor[ip='%s']/link-layer-address", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
+				}
+
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv4.nbor_list.nbor[j].phys_addr);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv4.nbor_list.nbor[j].phys_addr, LYD_ANYDATA_STRING, 0);
 			}
 		}
+	}
 
-		// ietf-ip
-		// mtu
-		mtu = rtnl_link_get_mtu(link);
+	// list of ipv6 addresses
+	if (l != NULL && addr_ver == 6) {
+		// enabled
+		uint8_t ipv6_enabled = l->ipv6.ip_data.enabled;
 
-		// list of ipv4 addresses
-		for (uint32_t i = 0; i < link_data_list.count; i++) {
-			if (link_data_list.links[i].name != NULL) { // in case we deleted a link it will be NULL
-				if (strcmp(link_data_list.links[i].name, interface_data.name ) == 0) {
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/enabled", interface_path_buffer);
+		if (error < 0) {
+			goto error_out;
+		}
+
+		SRP_LOG_DBG("%s = %d", xpath_buffer, ipv6_enabled);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, ipv6_enabled == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
+
+		// forwarding
+		uint8_t ipv6_forwarding = l->ipv6.ip_data.forwarding;
+
+		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/forwarding", interface_path_buffer);
+		if (error < 0) {
+			goto error_out;
+		}
+
+		SRP_LOG_DBG("%s = %d", xpath_buffer, ipv6_forwarding);
+		lyd_new_path(parent, ly_ctx, xpath_buffer, ipv6_forwarding == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
 
-					// enabled
-					// TODO
+		uint32_t ipv6_addr_count = l->ipv6.ip_data.addr_list.count;
 
-					// forwarding
-					uint8_t ipv4_forwarding = link_data_list.links[i].ipv4.forwarding;
+		for (uint32_t j = 0; j < ipv6_addr_count; j++) {
+			if (l->ipv6.ip_data.addr_list.addr[j].ip != NULL) { // in case we deleted an ip address it will be NULL
+				char *ip_addr = l->ipv6.ip_data.addr_list.addr[j].ip;
 
-					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/forwarding", interface_path_buffer);
+				// mtu
+				if (mtu > 0 && ip_addr != NULL) {
+					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/mtu", interface_path_buffer);
 					if (error < 0) {
 						goto error_out;
 					}
+					snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", mtu);
+					SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+					lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+				}
 
-					SRP_LOG_DBG("%s = %d", xpath_buffer, ipv4_forwarding);
-					lyd_new_path(*parent, ly_ctx, xpath_buffer, ipv4_forwarding == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
-
-					uint32_t ipv4_addr_count = link_data_list.links[i].ipv4.addr_list.count;
-
-					for (uint32_t j = 0; j < ipv4_addr_count; j++) {
-						if (link_data_list.links[i].ipv4.addr_list.addr[j].ip != NULL) { // in case we deleted an ip address it will be NULL
-							char *ip_addr = link_data_list.links[i].ipv4.addr_list.addr[j].ip;
-
-							if (mtu > 0) {
-								error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/mtu", interface_path_buffer);
-								if (error < 0) {
-									goto error_out;
-								}
-								snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", mtu);
-								SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
-								lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
-							}
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/address[ip='%s']/ip", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-							// ip
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv4.addr_list.addr[j].ip);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv4.addr_list.addr[j].ip, LYD_ANYDATA_STRING, 0);
-
-							// subnet
-							snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", link_data_list.links[i].ipv4.addr_list.addr[j].subnet);
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/address[ip='%s']/prefix-length", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-
-							SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
-						}
-					}
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/address[ip='%s']/ip", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
+				}
+				// ip
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv6.ip_data.addr_list.addr[j].ip);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv6.ip_data.addr_list.addr[j].ip, LYD_ANYDATA_STRING, 0);
 
-					// neighbors
-					uint32_t ipv4_neigh_count = link_data_list.links[i].ipv4.nbor_list.count;
-
-					for (uint32_t j = 0; j < ipv4_neigh_count; j++) {
-						if (link_data_list.links[i].ipv4.nbor_list.nbor[j].ip != NULL) { // in case we deleted an ip address it will be NULL
-							char *ip_addr = link_data_list.links[i].ipv4.nbor_list.nbor[j].ip;
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/neighbor[ip='%s']/ip", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-							// ip
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv4.nbor_list.nbor[j].ip);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv4.nbor_list.nbor[j].ip, LYD_ANYDATA_STRING, 0);
-
-							// link-layer-address
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv4/neighbor[ip='%s']/link-layer-address", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv4.nbor_list.nbor[j].phys_addr);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv4.nbor_list.nbor[j].phys_addr, LYD_ANYDATA_STRING, 0);
-						}
-					}
+				// subnet
+				snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", l->ipv6.ip_data.addr_list.addr[j].subnet);
+
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/address[ip='%s']/prefix-length", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
 				}
+
+				SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 			}
 		}
 
-		// list of ipv6 addresses
-		for (uint32_t i = 0; i < link_data_list.count; i++) {
-			if (link_data_list.links[i].name != NULL) { // in case we deleted a link it will be NULL
-				if (strcmp(link_data_list.links[i].name, interface_data.name ) == 0) {
+		// neighbors
+		uint32_t ipv6_neigh_count = l->ipv6.ip_data.nbor_list.count;
 
-					// enabled
-					uint8_t ipv6_enabled = link_data_list.links[i].ipv6.ip_data.enabled;
+		for (uint32_t j = 0; j < ipv6_neigh_count; j++) {
+			if (l->ipv6.ip_data.nbor_list.nbor[j].ip != NULL) { // in case we deleted an ip address it will be NULL
+				char *ip_addr = l->ipv6.ip_data.nbor_list.nbor[j].ip;
 
-					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/enabled", interface_path_buffer);
-					if (error < 0) {
-						goto error_out;
-					}
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/neighbor[ip='%s']/ip", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
+				}
+				// ip
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv6.ip_data.nbor_list.nbor[j].ip);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv6.ip_data.nbor_list.nbor[j].ip, LYD_ANYDATA_STRING, 0);
 
-					SRP_LOG_DBG("%s = %d", xpath_buffer, ipv6_enabled);
-					lyd_new_path(*parent, ly_ctx, xpath_buffer, ipv6_enabled == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
+				// link-layer-address
+				error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/neighbor[ip='%s']/link-layer-address", interface_path_buffer, ip_addr);
+				if (error < 0) {
+					goto error_out;
+				}
 
-					// forwarding
-					uint8_t ipv6_forwarding = link_data_list.links[i].ipv6.ip_data.forwarding;
+				SRP_LOG_DBG("%s = %s", xpath_buffer, l->ipv6.ip_data.nbor_list.nbor[j].phys_addr);
+				lyd_new_path(parent, ly_ctx, xpath_buffer, l->ipv6.ip_data.nbor_list.nbor[j].phys_addr, LYD_ANYDATA_STRING, 0);
+			}
+		}
+	}
 
-					error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/forwarding", interface_path_buffer);
-					if (error < 0) {
-						goto error_out;
-					}
+	return 0;
 
-					SRP_LOG_DBG("%s = %d", xpath_buffer, ipv6_forwarding);
-					lyd_new_path(*parent, ly_ctx, xpath_buffer, ipv6_forwarding == 0 ? "false" : "true", LYD_ANYDATA_STRING, 0);
-
-					uint32_t ipv6_addr_count = link_data_list.links[i].ipv6.ip_data.addr_list.count;
-
-					for (uint32_t j = 0; j < ipv6_addr_count; j++) {
-						if (link_data_list.links[i].ipv6.ip_data.addr_list.addr[j].ip != NULL) { // in case we deleted an ip address it will be NULL
-							char *ip_addr = link_data_list.links[i].ipv6.ip_data.addr_list.addr[j].ip;
-
-							// mtu
-							if (mtu > 0 && ip_addr != NULL) {
-								error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/mtu", interface_path_buffer);
-								if (error < 0) {
-									goto error_out;
-								}
-								snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", mtu);
-								SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
-								lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
-							}
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/address[ip='%s']/ip", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-							// ip
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv6.ip_data.addr_list.addr[j].ip);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv6.ip_data.addr_list.addr[j].ip, LYD_ANYDATA_STRING, 0);
-
-							// subnet
-							snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", link_data_list.links[i].ipv6.ip_data.addr_list.addr[j].subnet);
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/address[ip='%s']/prefix-length", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-
-							SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
-						}
-					}
+error_out:
+	return -1;
+}
 
-					// neighbors
-					uint32_t ipv6_neigh_count = link_data_list.links[i].ipv6.ip_data.nbor_list.count;
-
-					for (uint32_t j = 0; j < ipv6_neigh_count; j++) {
-						if (link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].ip != NULL) { // in case we deleted an ip address it will be NULL
-							char *ip_addr = link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].ip;
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/neighbor[ip='%s']/ip", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-							// ip
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].ip);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].ip, LYD_ANYDATA_STRING, 0);
-
-							// link-layer-address
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/ietf-ip:ipv6/neighbor[ip='%s']/link-layer-address", interface_path_buffer, ip_addr);
-							if (error < 0) {
-								goto error_out;
-							}
-
-							SRP_LOG_DBG("%s = %s", xpath_buffer, link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].phys_addr);
-							lyd_new_path(*parent, ly_ctx, xpath_buffer, link_data_list.links[i].ipv6.ip_data.nbor_list.nbor[j].phys_addr, LYD_ANYDATA_STRING, 0);
-						}
-					}
-				}
-			}
-		}
+// statistics container
+static int add_interface_statistics(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *interface_path_buffer, const link_stats_t *tmp_stats, const char *system_boot_time)
+{
+	int error = 0;
+	const nic_stats_t *nic_stats = &tmp_stats->nic;
 
-		// stats:
-		// discontinuity-time
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/discontinuity-time", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		SRP_LOG_DBG("%s = %s", xpath_buffer, interface_data.statistics.discontinuity_time);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, interface_data.statistics.discontinuity_time, LYD_ANYDATA_STRING, 0);
+	char tmp_buffer[PATH_MAX] = {0};
+	char xpath_buffer[PATH_MAX] = {0};
 
-		// in-octets
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-octets", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.in_octets);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	struct {
+		const char *discontinuity_time;
+		uint64_t in_octets;
+		uint64_t in_unicast_pkts;
+		uint64_t in_broadcast_pkts;
+		uint64_t in_multicast_pkts;
+		uint32_t in_discards;
+		uint32_t in_errors;
+		uint32_t in_unknown_protos;
+		uint64_t out_octets;
+		uint64_t out_unicast_pkts;
+		uint64_t out_broadcast_pkts;
+		uint64_t out_multicast_pkts;
+		uint32_t out_discards;
+		uint32_t out_errors;
+	} statistics = {0};
+
+	statistics.discontinuity_time = system_boot_time;
+
+	// Rx
+	statistics.in_octets = tmp_stats->rx_bytes;
+	statistics.in_broadcast_pkts = nic_stats->rx_broadcast;
+	statistics.in_multicast_pkts = tmp_stats->rx_multicast;
+	statistics.in_unicast_pkts = nic_stats->rx_packets - nic_stats->rx_broadcast - statistics.in_multicast_pkts;
+
+	statistics.in_discards = (uint32_t) tmp_stats->rx_dropped;
+	statistics.in_errors = (uint32_t) tmp_stats->rx_errors;
+	statistics.in_unknown_protos = (uint32_t) tmp_stats->rx_unknown_protos;
+
+	// Tx
+	statistics.out_octets = tmp_stats->tx_bytes;
+	statistics.out_broadcast_pkts = nic_stats->tx_broadcast;
+	statistics.out_multicast_pkts = nic_stats->tx_multicast;
+	statistics.out_unicast_pkts = nic_stats->tx_packets - nic_stats->tx_broadcast - nic_stats->tx_multicast;
+
+	statistics.out_discards = (uint32_t) tmp_stats->tx_dropped;
+	statistics.out_errors = (uint32_t) tmp_stats->tx_errors;
+
+	// stats:
+	// discontinuity-time
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/discontinuity-time", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	SRP_LOG_DBG("%s = %s", xpath_buffer, statistics.discontinuity_time);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, statistics.discontinuity_time, LYD_ANYDATA_STRING, 0);
 
-		// in-unicast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-unicast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.in_unicast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// in-octets
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-octets", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.in_octets);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// in-broadcast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-broadcast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.in_broadcast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// in-unicast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-unicast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.in_unicast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// in-multicast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-multicast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.in_multicast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// in-broadcast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-broadcast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.in_broadcast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// in-discards
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-discards", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.statistics.in_discards);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// in-multicast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-multicast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.in_multicast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// in-discards
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-discards", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", statistics.in_discards);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// in-errors
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-errors", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", statistics.in_errors);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// in-unknown-protos
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-unknown-protos", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", statistics.in_unknown_protos);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// out-octets
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-octets", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.out_octets);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// out-unicast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-unicast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.out_unicast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+
+	// out-broadcast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-broadcast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.out_broadcast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// in-errors
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-errors", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.statistics.in_errors);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// out-multicast-pkts
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-multicast-pkts", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", statistics.out_multicast_pkts);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// in-unknown-protos
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/in-unknown-protos", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.statistics.in_unknown_protos);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// out-discards
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-discards", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", statistics.out_discards);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// out-octets
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-octets", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.out_octets);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	// out-errors
+	error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-errors", interface_path_buffer);
+	if (error < 0) {
+		goto error_out;
+	}
+	snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", statistics.out_errors);
+	lyd_new_path(parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
 
-		// out-unicast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-unicast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.out_unicast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	return 0;
 
-		// out-broadcast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-broadcast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.out_broadcast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+error_out:
+	return -1;
+}
 
-		// out-multicast-pkts
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-multicast-pkts", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%lu", interface_data.statistics.out_multicast_pkts);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+// called once per statistics container - the parent is the statistics node of one interface
+static int interfaces_rates_data_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = 0;
+	const char *name = NULL;
+	int ifindex = 0;
+	const link_stats_list_t *stats = NULL;
+	const link_stats_t *st = NULL;
+	char xpath_buffer[PATH_MAX] = {0};
+	char tmp_buffer[PATH_MAX] = {0};
 
-		// out-discards
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-discards", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.statistics.out_discards);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	const char *RATE_LEAVES[] = {"in-bps", "in-pps", "out-bps", "out-pps"};
 
-		// out-errors
-		error = snprintf(xpath_buffer, sizeof(xpath_buffer), "%s/statistics/out-errors", interface_path_buffer);
-		if (error < 0) {
-			goto error_out;
-		}
-		snprintf(tmp_buffer, sizeof(tmp_buffer), "%u", interface_data.statistics.out_errors);
-		lyd_new_path(*parent, ly_ctx, xpath_buffer, tmp_buffer, LYD_ANYDATA_STRING, 0);
+	if (*parent == NULL) {
+		return SR_ERR_OK;
+	}
 
-		// free all allocated data
-		FREE_SAFE(interface_data.phys_address);
+	// the snapshot is indexed by ifindex - taken from the interface entry above the statistics container
+	if (get_parent_interface(lyd_parent(*parent), &name, &ifindex) != 0) {
+		return SR_ERR_OK;
+	}
 
-		// continue to next link node
-		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	stats = stats_sampler_acquire(&stats_sampler);
+
+	st = link_stats_list_get(stats, ifindex);
+	if (st == NULL || !st->has_rates) {
+		goto out;
 	}
 
-	rtnl_qdisc_put(qdisc);
-	nl_cache_free(cache);
+	for (unsigned int i = 0; i < stats_sampler.rate_window_count; i++) {
+		const link_rate_t *rate = &st->rates[i];
+		const double VALUES[] = {rate->in_bps, rate->in_pps, rate->out_bps, rate->out_pps};
 
-	error = SR_ERR_OK; // set error to OK, since it will be modified by snprintf
+		for (size_t j = 0; j < sizeof(RATE_LEAVES) / sizeof(RATE_LEAVES[0]); j++) {
+			error = snprintf(xpath_buffer, sizeof(xpath_buffer), RATES_YANG_MODEL ":rate[window='%u']/%s", stats_sampler.rate_windows[i], RATE_LEAVES[j]);
+			if (error < 0) {
+				goto error_out;
+			}
+
+			snprintf(tmp_buffer, sizeof(tmp_buffer), "%" PRIu64, (uint64_t) (VALUES[j] + 0.5));
+			SRP_LOG_DBG("%s = %s", xpath_buffer, tmp_buffer);
+
+			error = lyd_new_path(*parent, NULL, xpath_buffer, tmp_buffer, 0, NULL);
+			if (error != LY_SUCCESS) {
+				SRP_LOG_ERR("lyd_new_path error (%d)", error);
+				goto error_out;
+			}
+		}
+	}
 
+	error = 0;
 	goto out;
 
 error_out:
-	error = SR_ERR_CALLBACK_FAILED;
+	error = -1;
 
 out:
-	for (uint64_t i = 0; i < master_list.count; i++) {
-		for (uint64_t j = 0; j < master_list.masters[i].count; j++) {
-			FREE_SAFE(master_list.masters[i].master_names[j]);
-		}
-		FREE_SAFE(master_list.masters[i].slave_name);
-	}
-
-	for (uint64_t i = 0; i < slave_list.count; i++) {
-		for (uint64_t j = 0; j < slave_list.slaves[i].count; j++) {
-			FREE_SAFE(slave_list.slaves[i].slave_names[j]);
-		}
-		FREE_SAFE(slave_list.slaves[i].master_name);
-	}
+	stats_sampler_release(&stats_sampler);
 
-	nl_socket_free(socket);
 	return error ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
 }
 
-static int get_system_boot_time(char boot_datetime[])
+// nominal speed of the link in bits per second - fails for links without one (e.g. virtual or down links)
+static int get_link_speed(const char *name, uint64_t *speed)
 {
-	time_t now = 0;
-	struct tm *ts = {0};
-	struct sysinfo s_info = {0};
-	time_t uptime_seconds = 0;
-
-	now = time(NULL);
+	char path[PATH_MAX] = {0};
+	FILE *fp = NULL;
+	long mbps = -1;
 
-	ts = localtime(&now);
-	if (ts == NULL)
-		return -1;
+	snprintf(path, sizeof(path), "/sys/class/net/%s/speed", name);
 
-	if (sysinfo(&s_info) != 0)
+	fp = fopen(path, "r");
+	if (fp == NULL) {
 		return -1;
+	}
 
-	uptime_seconds = s_info.uptime;
-
-	time_t diff = now - uptime_seconds;
-
-	ts = localtime(&diff);
-	if (ts == NULL)
+	// reading the attribute fails with EINVAL for links not reporting a speed
+	if (fscanf(fp, "%ld", &mbps) != 1 || mbps <= 0) {
+		fclose(fp);
 		return -1;
+	}
 
-	/* must satisfy constraint (type yang:date-and-time):
-		"\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d+)?(Z|[\+\-]\d{2}:\d{2})"
-		TODO: Add support for:
-			- 2021-02-09T06:02:39.234+01:00
-			- 2021-02-09T06:02:39.234Z
-			- 2021-02-09T06:02:39+11:11
-	*/
+	fclose(fp);
 
-	strftime(boot_datetime, DATETIME_BUF_SIZE, "%FT%TZ", ts);
+	*speed = (uint64_t) mbps * 1000000;
 
 	return 0;
 }
 
-static int init_state_changes(void)
+static int get_link_mtu(const char *name, unsigned int *mtu)
 {
+	char path[PATH_MAX] = {0};
+	FILE *fp = NULL;
 	int error = 0;
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
-	struct rtnl_link *link = NULL;
-	if_state_t *tmp_st = NULL;
-	pthread_attr_t attr;
 
-	uint if_cnt = 0;
+	snprintf(path, sizeof(path), "/sys/class/net/%s/mtu", name);
 
-	struct {
-		pthread_t *data;
-		uint count;
-	} thread_ls;
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		return -1;
+	}
 
-	pthread_t manager_thread;
+	error = fscanf(fp, "%u", mtu) == 1 ? 0 : -1;
+	fclose(fp);
 
-	pthread_attr_init(&attr);
-	pthread_attr_setdetachstate(&attr, 1);
+	return error;
+}
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("nl_socket_alloc error: invalid socket");
-		return -1;
+// ifindex of the link this one is stacked on (IFLA_LINK), 0 if none
+static int get_lower_link(struct rtnl_link *link)
+{
+	int32_t netnsid = 0;
+	const char *type = rtnl_link_get_type(link);
+
+	// veth reports its peer as the link and a link in another namespace has no name here
+	if ((type != NULL && strcmp(type, "veth") == 0) || rtnl_link_get_link_netnsid(link, &netnsid) == 0) {
+		return 0;
 	}
 
-	if ((error = nl_connect(socket, NETLINK_ROUTE)) != 0) {
-		SRP_LOG_ERR("nl_connect error (%d): %s", error, nl_geterror(error));
-		goto error_out;
+	return rtnl_link_get_link(link);
+}
+
+static void update_link_layers(struct rtnl_link *link)
+{
+	link_layers_set(&link_layers, rtnl_link_get_ifindex(link), rtnl_link_get_name(link), rtnl_link_get_master(link), get_lower_link(link));
+}
+
+// add a higher-layer-if or lower-layer-if entry - links without a known name are skipped
+static void add_layer_if(struct lyd_node *parent, const struct ly_ctx *ly_ctx, const char *xpath, int ifindex)
+{
+	const char *name = link_layers_get_name(&link_layers, ifindex);
+
+	if (name == NULL) {
+		return;
 	}
 
-	error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
+	SRP_LOG_DBG("%s += %s", xpath, name);
+	lyd_new_path(parent, ly_ctx, xpath, (char *) name, LYD_ANYDATA_STRING, 0);
+}
+
+// the manager dumps the links once when the cache is added - its thread is started by init_state_changes
+static int init_link_manager(void)
+{
+	int error = 0;
+	struct rtnl_link *link = NULL;
+
+	error = nl_cache_mngr_alloc(NULL, NETLINK_ROUTE, 0, &link_manager);
 	if (error != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache error (%d): %s", error, nl_geterror(error));
-		goto error_out;
+		SRP_LOG_ERR("nl_cache_mngr_alloc failed (%d): %s", error, nl_geterror(error));
+		return error;
 	}
 
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	error = nl_cache_mngr_add(link_manager, "route/link", cache_change_cb, NULL, &link_cache);
+	if (error != 0) {
+		SRP_LOG_ERR("nl_cache_mngr_add failed (%d): %s", error, nl_geterror(error));
+		return error;
+	}
 
+	// filled once from the initial cache contents - cache_change_cb keeps it up to date from now on
+	link = (struct rtnl_link *) nl_cache_get_first(link_cache);
 	while (link != NULL) {
-		++if_cnt;
-
+		update_link_layers(link);
 		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
 	}
 
+	return 0;
+}
+
+// link states are taken from the startup snapshot - it matches link_cache, changes after it are queued for the manager thread
+static int init_state_changes(const link_snapshot_t *snapshot)
+{
+	int error = 0;
+	struct rtnl_link *link = NULL;
+	if_state_t *tmp_st = NULL;
+
+	uint if_cnt = 0;
+
+	if_cnt = (uint) nl_cache_nitems(snapshot->links);
+
 	// allocate a list to contain if_cnt number of interface states
 	if_state_list_alloc(&if_state_changes, if_cnt);
 
-	thread_ls.data = (pthread_t *) malloc(sizeof(pthread_t) * if_cnt);
-	thread_ls.count = if_cnt;
-
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	link = (struct rtnl_link *) nl_cache_get_first(snapshot->links);
 	if_cnt = 0;
 
 	while (link != NULL) {
@@ -3409,72 +3668,332 @@ static int init_state_changes(void)
 			tmp_st->name = xcalloc(len + 1, sizeof(char));
 			strncpy(tmp_st->name, tmp_name, len);
 			tmp_st->name[len] = '\0';
+
+			if_state_list_set_ifindex(&if_state_changes, tmp_st, rtnl_link_get_ifindex(link));
 		}
 
 		++if_cnt;
 		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
 	}
 
-	error = nl_cache_mngr_alloc(NULL, NETLINK_ROUTE, 0, &link_manager);
+	manager_wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (manager_wakeup_fd == -1) {
+		SRP_LOG_ERR("eventfd error: %s", strerror(errno));
+		return -1;
+	}
+
+	// joined on cleanup
+	error = pthread_create(&manager_thread, NULL, manager_thread_cb, 0);
 	if (error != 0) {
-		SRP_LOG_ERR("nl_cache_mngr_alloc failed (%d): %s", error, nl_geterror(error));
+		SRP_LOG_ERR("pthread_create error (%d)", error);
+		close(manager_wakeup_fd);
+		manager_wakeup_fd = -1;
+		return error;
+	}
+
+	return 0;
+}
+
+static int init_stats_sampler(void)
+{
+	int error = 0;
+	unsigned long interval_ms = STATS_INTERVAL_DEFAULT_MS;
+	const char *interval_env = getenv(STATS_INTERVAL_ENV);
+	char *end = NULL;
+
+	const char *windows_env = getenv(RATE_WINDOWS_ENV);
+	unsigned int windows[LINK_STATS_MAX_RATE_WINDOWS] = {0};
+	unsigned int window_count = 0;
+
+	stats_sampler_init(&stats_sampler);
+
+	if (parse_rate_windows(windows_env != NULL ? windows_env : RATE_WINDOWS_DEFAULT, windows, &window_count) != 0) {
+		SRP_LOG_ERR("invalid %s value: %s - expected at most %d comma separated windows in seconds", RATE_WINDOWS_ENV, windows_env, LINK_STATS_MAX_RATE_WINDOWS);
+		return -1;
+	}
+	stats_sampler_set_rate_windows(&stats_sampler, windows, window_count);
+
+	if (interval_env != NULL) {
+		errno = 0;
+		interval_ms = strtoul(interval_env, &end, 10);
+		if (errno != 0 || end == interval_env || *end != '\0' || interval_ms > UINT_MAX) {
+			SRP_LOG_ERR("invalid %s value: %s", STATS_INTERVAL_ENV, interval_env);
+			return -1;
+		}
+	}
+
+	stats_socket = nl_socket_alloc();
+	if (stats_socket == NULL) {
+		SRP_LOG_ERR("nl_socket_alloc error: invalid socket");
+		return -1;
+	}
+
+	error = nl_connect(stats_socket, NETLINK_ROUTE);
+	if (error != 0) {
+		SRP_LOG_ERR("nl_connect error (%d): %s", error, nl_geterror(error));
 		goto error_out;
 	}
 
-	error = nl_cache_mngr_add(link_manager, "route/link", cache_change_cb, NULL, &link_cache);
+	if (interval_ms == 0) {
+		SRP_LOG_INF("statistics sampling disabled - counters are collected on every request");
+		return 0;
+	}
+
+	error = stats_sampler_start(&stats_sampler, (unsigned int) interval_ms, collect_link_stats, stats_socket);
 	if (error != 0) {
-		SRP_LOG_ERR("nl_cache_mngr_add failed (%d): %s", error, nl_geterror(error));
+		SRP_LOG_ERR("stats_sampler_start error");
 		goto error_out;
 	}
 
-	pthread_create(&manager_thread, NULL, manager_thread_cb, 0);
+	SRP_LOG_INF("sampling statistics every %lu ms", interval_ms);
 
-	pthread_detach(manager_thread);
+	return 0;
 
 error_out:
+	nl_socket_free(stats_socket);
+	stats_socket = NULL;
 
-	// clear libnl data
-	nl_cache_free(cache);
-	nl_socket_free(socket);
+	return -1;
+}
+
+static int parse_rate_windows(const char *str, unsigned int *windows, unsigned int *count)
+{
+	const char *ptr = str;
+	char *end = NULL;
+	unsigned long window = 0;
+
+	*count = 0;
 
-	// free tmp struct
-	if (thread_ls.count) {
-		free(thread_ls.data);
+	while (*ptr != '\0') {
+		errno = 0;
+		window = strtoul(ptr, &end, 10);
+		if (errno != 0 || end == ptr || window == 0 || window > UINT_MAX || *count == LINK_STATS_MAX_RATE_WINDOWS) {
+			return -1;
+		}
+
+		windows[(*count)++] = (unsigned int) window;
+
+		if (*end == ',') {
+			end++;
+		} else if (*end != '\0') {
+			return -1;
+		}
+		ptr = end;
 	}
-	return error;
+
+	return 0;
 }
 
-static void cache_change_cb(struct nl_cache *cache, struct nl_object *obj, int val, void *arg)
+// kernel counters of all links with one RTM_GETSTATS dump, then the ethtool counters of each link
+// called from the sampler thread, or from the operational callback if sampling is disabled
+static int collect_link_stats(link_stats_list_t *ls, void *arg)
 {
+	struct nl_sock *socket = (struct nl_sock *) arg;
 	struct rtnl_link *link = NULL;
+	link_stats_t *st = NULL;
+	struct {
+		int ifindex;
+		char name[IFNAMSIZ];
+	} *links = NULL;
+	unsigned int links_count = 0;
+	int error = 0;
+
+	error = link_stats_list_collect(ls, socket, 0);
+	if (error != 0) {
+		SRP_LOG_ERR("link_stats_list_collect error (%d): %s", error, nl_geterror(error));
+		return -1;
+	}
+
+	// one netlink dump for the links whose drivers report the standard MAC statistics - the rest use the ioctl
+	if (nic_stats_engine_refresh(&nic_stats_engine, 0) != 0) {
+		SRP_LOG_DBG("nic_stats_engine_refresh failed - reading ethtool statistics per link");
+	}
+
+	// the ioctl fallback needs link names - copy them out of the cache so that the ioctls
+	// don't hold the read lock and block the link manager
+	if (ls->count == 0) {
+		return 0;
+	}
+
+	links = xmalloc(sizeof(*links) * ls->count);
+
+	pthread_rwlock_rdlock(&link_cache_lock);
+
+	link = (struct rtnl_link *) nl_cache_get_first(link_cache);
+	while (link != NULL && links_count < ls->count) {
+		const int IFINDEX = rtnl_link_get_ifindex(link);
+
+		if (link_stats_list_get(ls, IFINDEX) != NULL) {
+			links[links_count].ifindex = IFINDEX;
+			snprintf(links[links_count].name, sizeof(links[links_count].name), "%s", rtnl_link_get_name(link));
+			links_count += 1;
+		}
+
+		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	}
+
+	pthread_rwlock_unlock(&link_cache_lock);
+
+	for (unsigned int i = 0; i < links_count; i++) {
+		st = link_stats_list_get(ls, links[i].ifindex);
+		if (nic_stats_engine_get(&nic_stats_engine, links[i].ifindex, links[i].name, &st->nic) != 0) {
+			SRP_LOG_DBG("nic_stats_engine_get error for %s: %s", links[i].name, strerror(errno));
+		}
+	}
+
+	FREE_SAFE(links);
+
+	return 0;
+}
+
+// counters of a single link - used when sampling is disabled and only one interface is requested
+static int collect_single_link_stats(link_stats_list_t *ls, struct nl_sock *socket, int ifindex, const char *name)
+{
+	link_stats_t *st = NULL;
+	int error = 0;
+
+	error = link_stats_list_collect(ls, socket, ifindex);
+	if (error != 0) {
+		SRP_LOG_ERR("link_stats_list_collect error (%d): %s", error, nl_geterror(error));
+		return -1;
+	}
+
+	// values of earlier dumps are stale - ask for the netlink statistics of this link only, the ioctl is used without them
+	nic_stats_engine_refresh(&nic_stats_engine, ifindex);
+
+	st = link_stats_list_get(ls, ifindex);
+	if (st != NULL && nic_stats_engine_get(&nic_stats_engine, ifindex, name, &st->nic) != 0) {
+		SRP_LOG_DBG("nic_stats_engine_get error for %s: %s", name, strerror(errno));
+	}
+
+	return 0;
+}
+
+// only the changed link is looked at - its state is found through the ifindex index
+// links created or removed after startup get their state entry added or removed here
+static void cache_change_cb(struct nl_cache *cache, struct nl_object *obj, int val, void *arg)
+{
+	struct rtnl_link *link = (struct rtnl_link *) obj;
 	char *name = NULL;
 	if_state_t *tmp_st = NULL;
 	uint8_t tmp_state = 0;
+	int ifindex = 0;
 
 	SRP_LOG_DBG("entered cb function for a link manager");
 
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
+	name = rtnl_link_get_name(link);
+	ifindex = rtnl_link_get_ifindex(link);
+	tmp_state = rtnl_link_get_operstate(link);
 
-	while (link != NULL) {
-		name = rtnl_link_get_name(link);
-		tmp_st = if_state_list_get_by_if_name(&if_state_changes, name);
-		tmp_state = rtnl_link_get_operstate(link);
+	// the driver or its string set may have changed with the link - resolve the ethtool layout again on the next read
+	// only takes the engine table lock, which no ethtool request holds - link_cache_lock isn't held up by a running read
+	if (val != NL_ACT_NEW) {
+		nic_stats_engine_invalidate(&nic_stats_engine, ifindex);
+	}
+
+	// called with link_cache_lock write locked - the layer index is read under the same lock
+	if (val == NL_ACT_DEL) {
+		link_layers_remove(&link_layers, ifindex);
+	} else {
+		update_link_layers(link);
+	}
 
-		if (tmp_state != tmp_st->state) {
-			SRP_LOG_DBG("Interface %s changed operstate from %d to %d", name, tmp_st->state, tmp_state);
-			tmp_st->state = tmp_state;
-			tmp_st->last_change = time(NULL);
+	pthread_mutex_lock(&if_state_changes_lock);
+
+	tmp_st = if_state_list_bind(&if_state_changes, ifindex, name);
+
+	if (val == NL_ACT_DEL) {
+		if (tmp_st != NULL) {
+			SRP_LOG_DBG("Interface %s removed", name);
+			if_state_list_remove(&if_state_changes, tmp_st);
 		}
-		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	} else if (tmp_st == NULL) {
+		SRP_LOG_DBG("Interface %s added with operstate %d", name, tmp_state);
+		tmp_st = if_state_list_add(&if_state_changes, tmp_state, name);
+		if_state_set_last_change(tmp_st, time(NULL));
+		if_state_list_set_ifindex(&if_state_changes, tmp_st, ifindex);
+	} else if (tmp_state != tmp_st->state) {
+		SRP_LOG_DBG("Interface %s changed operstate from %d to %d", name, tmp_st->state, tmp_state);
+		tmp_st->state = tmp_state;
+		if_state_set_last_change(tmp_st, time(NULL));
 	}
+
+	pthread_mutex_unlock(&if_state_changes_lock);
 }
 
 static void *manager_thread_cb(void *data)
 {
-	do {
-		nl_cache_mngr_data_ready(link_manager);
-		sleep(1);
-	} while (exit_application == 0);
+	int epoll_fd = -1;
+	int nl_err = 0;
+	const int MANAGER_FD = nl_cache_mngr_get_fd(link_manager);
+	struct epoll_event event = {0};
+	struct epoll_event events[3];
+
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd == -1) {
+		SRP_LOG_ERR("epoll_create1 error: %s", strerror(errno));
+		goto out;
+	}
+
+	event.events = EPOLLIN;
+	event.data.fd = MANAGER_FD;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, MANAGER_FD, &event) == -1) {
+		SRP_LOG_ERR("epoll_ctl error: %s", strerror(errno));
+		goto out;
+	}
+
+	event.events = EPOLLIN;
+	event.data.fd = manager_wakeup_fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, manager_wakeup_fd, &event) == -1) {
+		SRP_LOG_ERR("epoll_ctl error: %s", strerror(errno));
+		goto out;
+	}
+
+	event.events = EPOLLIN;
+	event.data.fd = timestamp_cache.timer_fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timestamp_cache.timer_fd, &event) == -1) {
+		SRP_LOG_ERR("epoll_ctl error: %s", strerror(errno));
+		goto out;
+	}
+
+	while (exit_application == 0) {
+		const int COUNT = epoll_wait(epoll_fd, events, sizeof(events) / sizeof(events[0]), -1);
+
+		if (COUNT == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			SRP_LOG_ERR("epoll_wait error: %s", strerror(errno));
+			break;
+		}
+
+		for (int i = 0; i < COUNT; i++) {
+			if (events[i].data.fd == manager_wakeup_fd) {
+				goto out;
+			}
+
+			if (events[i].data.fd == timestamp_cache.timer_fd) {
+				SRP_LOG_DBG("realtime clock set - rendering the boot time again");
+				if (timestamp_cache_refresh(&timestamp_cache) != 0) {
+					SRP_LOG_ERR("timestamp_cache_refresh error: %s", strerror(errno));
+				}
+				continue;
+			}
+
+			// reads every queued message - bursts are processed at once instead of waiting in the socket
+			pthread_rwlock_wrlock(&link_cache_lock);
+			nl_err = nl_cache_mngr_data_ready(link_manager);
+			pthread_rwlock_unlock(&link_cache_lock);
+			if (nl_err < 0) {
+				SRP_LOG_ERR("nl_cache_mngr_data_ready error (%d): %s", nl_err, nl_geterror(nl_err));
+			}
+		}
+	}
+
+out:
+	if (epoll_fd != -1) {
+		close(epoll_fd);
+	}
 
 	return NULL;
 }
@@ -3519,7 +4038,10 @@ int main(void)
 	}
 
 out:
-	sr_plugin_cleanup_cb(session, private_data);
+	// a failed init has already freed everything it started
+	if (private_data != NULL) {
+		sr_plugin_cleanup_cb(session, private_data);
+	}
 	sr_disconnect(connection);
 
 	pthread_exit(0);
@@ -20,9 +20,20 @@
 #include <string.h>
 #include <errno.h>
 
+#define LD_INITIAL_CAPACITY 64
+
+static uint32_t link_data_name_hash(const char *name);
+static uint32_t link_data_ifindex_hash(int ifindex);
+static uint32_t link_data_find_name_slot(link_data_list_t *ld, const char *name, uint32_t hash);
+static uint32_t link_data_find_ifindex_slot(link_data_list_t *ld, int ifindex);
+static void link_data_index_insert(link_data_index_slot_t *index, uint32_t index_size, uint32_t hash, uint32_t position);
+static void link_data_index_remove(link_data_index_slot_t *index, uint32_t index_size, uint32_t slot);
+static void link_data_list_index_resize(link_data_list_t *ld, uint32_t index_size);
+
 void link_data_init(link_data_t *l)
 {
 	l->name = NULL;
+	l->ifindex = 0;
 	l->description = NULL;
 	l->type = NULL;
 	l->enabled = NULL;
@@ -38,10 +49,14 @@ void link_data_init(link_data_t *l)
 
 int link_data_list_init(link_data_list_t *ld)
 {
-	for (int i = 0; i < LD_MAX_LINKS; i++) {
-		link_data_init(&ld->links[i]);
-	}
+	ld->links = NULL;
 	ld->count = 0;
+	ld->capacity = 0;
+	ld->name_index = NULL;
+	ld->ifindex_index = NULL;
+	ld->index_size = 0;
+	ld->free_list = NULL;
+	ld->free_count = 0;
 
 	return 0;
 }
@@ -53,37 +68,64 @@ void link_data_set_name(link_data_t *l, char *name)
 
 int link_data_list_add(link_data_list_t *ld, char *name)
 {
-	bool name_found = false;
+	uint32_t pos = 0;
 
-	if (ld->count >= LD_MAX_LINKS) {
-		return EINVAL;
+	if (data_list_get_by_name(ld, name) != NULL) {
+		return 0;
 	}
 
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) { // in case we deleted a link it will be NULL
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = true;
-				break;
-			}
-		}
+	// keep the indexes at most half full - live links are count - free_count
+	if ((ld->count - ld->free_count + 1) * 2 > ld->index_size) {
+		link_data_list_index_resize(ld, ld->index_size ? ld->index_size * 2 : LD_INITIAL_CAPACITY * 2);
 	}
 
-	if (!name_found) {
-		// set the new link to the first free one in the list
-		// the one with name == 0
-		int pos = ld->count;
-		for (int i = 0; i < ld->count; i++) {
-			if (ld->links[i].name == NULL) {
-				pos = i;
-				break;
-			}
-		}
-		link_data_set_name(&ld->links[pos], name);
-		if (pos == ld->count) {
-			++ld->count;
+	if (ld->free_count > 0) {
+		// reuse the hole of a removed link
+		pos = ld->free_list[--ld->free_count];
+	} else {
+		if (ld->count == ld->capacity) {
+			ld->capacity = ld->capacity ? ld->capacity * 2 : LD_INITIAL_CAPACITY;
+			ld->links = xrealloc(ld->links, sizeof(link_data_t) * ld->capacity);
+			ld->free_list = xrealloc(ld->free_list, sizeof(uint32_t) * ld->capacity);
 		}
+		pos = ld->count++;
+	}
+
+	link_data_init(&ld->links[pos]);
+	link_data_set_name(&ld->links[pos], name);
+	link_data_index_insert(ld->name_index, ld->index_size, link_data_name_hash(name), pos);
+
+	return 0;
+}
+
+// frees the link data and leaves a hole in its position - positions of the other links don't change
+int link_data_list_remove(link_data_list_t *ld, char *name)
+{
+	uint32_t slot = 0;
+	uint32_t pos = 0;
+	link_data_t *l = NULL;
+
+	if (ld->index_size == 0) {
+		return EINVAL;
+	}
+
+	slot = link_data_find_name_slot(ld, name, link_data_name_hash(name));
+	if (ld->name_index[slot].position == 0) {
+		return EINVAL;
 	}
 
+	pos = ld->name_index[slot].position - 1;
+	l = &ld->links[pos];
+
+	link_data_index_remove(ld->name_index, ld->index_size, slot);
+	if (l->ifindex > 0) {
+		link_data_index_remove(ld->ifindex_index, ld->index_size, link_data_find_ifindex_slot(ld, l->ifindex));
+	}
+
+	link_data_free(l);
+	link_data_init(l);
+	ld->free_list[ld->free_count++] = pos;
+
 	return 0;
 }
 
@@ -447,152 +489,158 @@ int link_data_list_set_delete(link_data_list_t *ld, char *name, bool delete)
 }
 
 link_data_t *data_list_get_by_name(link_data_list_t *ld, char *name)
+{
+	uint32_t slot = 0;
+
+	if (ld->index_size == 0 || name == NULL) {
+		return NULL;
+	}
+
+	slot = link_data_find_name_slot(ld, name, link_data_name_hash(name));
+	if (ld->name_index[slot].position == 0) {
+		return NULL;
+	}
+
+	return &ld->links[ld->name_index[slot].position - 1];
+}
+
+link_data_t *data_list_get_by_ifindex(link_data_list_t *ld, int ifindex)
+{
+	uint32_t slot = 0;
+
+	if (ld->index_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = link_data_find_ifindex_slot(ld, ifindex);
+	if (ld->ifindex_index[slot].position == 0) {
+		return NULL;
+	}
+
+	return &ld->links[ld->ifindex_index[slot].position - 1];
+}
+
+int link_data_list_set_ifindex(link_data_list_t *ld, char *name, int ifindex)
 {
 	link_data_t *l = NULL;
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				l = &ld->links[i];
-				break;
-			}
-		}
+	link_data_t *other = NULL;
+	uint32_t pos = 0;
+
+	l = data_list_get_by_name(ld, name);
+	if (l == NULL) {
+		return EINVAL;
+	}
+
+	if (l->ifindex == ifindex) {
+		return 0;
+	}
+
+	if (l->ifindex > 0) {
+		link_data_index_remove(ld->ifindex_index, ld->index_size, link_data_find_ifindex_slot(ld, l->ifindex));
+	}
+
+	// an index can only belong to one link - the kernel reuses indexes of deleted links
+	other = data_list_get_by_ifindex(ld, ifindex);
+	if (other != NULL) {
+		link_data_index_remove(ld->ifindex_index, ld->index_size, link_data_find_ifindex_slot(ld, ifindex));
+		other->ifindex = 0;
 	}
-	return l;
+
+	l->ifindex = ifindex;
+	if (ifindex > 0) {
+		pos = (uint32_t) (l - ld->links);
+		link_data_index_insert(ld->ifindex_index, ld->index_size, link_data_ifindex_hash(ifindex), pos);
+	}
+
+	return 0;
 }
 
-// TODO: update
 int link_data_list_set_parent(link_data_list_t *ld, char *name, char *parent)
 {
 	int error = 0;
-	int name_found = 0;
-
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = 1;
-
-				if (ld->links[i].extensions.parent_interface  != NULL) {
-					FREE_SAFE(ld->links[i].extensions.parent_interface);
-				}
+	link_data_t *l = NULL;
 
-				unsigned long tmp_len = 0;
-				tmp_len = strlen(parent);
-				ld->links[i].extensions.parent_interface = xmalloc(sizeof(char) * (tmp_len + 1));
-				memcpy(ld->links[i].extensions.parent_interface, parent, tmp_len);
-				ld->links[i].extensions.parent_interface[tmp_len] = 0;
+	l = data_list_get_by_name(ld, name);
 
-				break;
-			}
+	if (l != NULL) {
+		if (l->extensions.parent_interface != NULL) {
+			FREE_SAFE(l->extensions.parent_interface);
 		}
-	}
-	if (!name_found) {
-		// error
+		l->extensions.parent_interface = xstrdup(parent);
+	} else {
 		error = EINVAL;
 	}
+
 	return error;
 }
 
 int link_data_list_set_outer_vlan_id(link_data_list_t *ld, char *name, uint16_t outer_vlan_id)
 {
 	int error = 0;
-	int name_found = 0;
-
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = 1;
-				ld->links[i].extensions.encapsulation.dot1q_vlan.outer_vlan_id = outer_vlan_id;
-				break;
-			}
-		}
-	}
-	if (!name_found) {
-		// error
+	link_data_t *l = NULL;
+
+	l = data_list_get_by_name(ld, name);
+
+	if (l != NULL) {
+		l->extensions.encapsulation.dot1q_vlan.outer_vlan_id = outer_vlan_id;
+	} else {
 		error = EINVAL;
 	}
+
 	return error;
 }
 
 int link_data_list_set_outer_tag_type(link_data_list_t *ld, char *name, char *outer_tag_type)
 {
 	int error = 0;
-	int name_found = 0;
-
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = 1;
-
-				if (ld->links[i].extensions.encapsulation.dot1q_vlan.outer_tag_type  != NULL) {
-					FREE_SAFE(ld->links[i].extensions.encapsulation.dot1q_vlan.outer_tag_type);
-				}
+	link_data_t *l = NULL;
 
-				unsigned long tmp_len = 0;
-				tmp_len = strlen(outer_tag_type);
-				ld->links[i].extensions.encapsulation.dot1q_vlan.outer_tag_type = xmalloc(sizeof(char) * (tmp_len + 1));
-				memcpy(ld->links[i].extensions.encapsulation.dot1q_vlan.outer_tag_type, outer_tag_type, tmp_len);
-				ld->links[i].extensions.encapsulation.dot1q_vlan.outer_tag_type[tmp_len] = 0;
+	l = data_list_get_by_name(ld, name);
 
-				break;
-			}
+	if (l != NULL) {
+		if (l->extensions.encapsulation.dot1q_vlan.outer_tag_type != NULL) {
+			FREE_SAFE(l->extensions.encapsulation.dot1q_vlan.outer_tag_type);
 		}
-	}
-	if (!name_found) {
-		// error
+		l->extensions.encapsulation.dot1q_vlan.outer_tag_type = xstrdup(outer_tag_type);
+	} else {
 		error = EINVAL;
 	}
+
 	return error;
 }
 
 int link_data_list_set_second_vlan_id(link_data_list_t *ld, char *name, uint16_t second_vlan_id)
 {
 	int error = 0;
-	int name_found = 0;
-
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = 1;
-				ld->links[i].extensions.encapsulation.dot1q_vlan.second_vlan_id = second_vlan_id;
-				break;
-			}
-		}
-	}
-	if (!name_found) {
-		// error
+	link_data_t *l = NULL;
+
+	l = data_list_get_by_name(ld, name);
+
+	if (l != NULL) {
+		l->extensions.encapsulation.dot1q_vlan.second_vlan_id = second_vlan_id;
+	} else {
 		error = EINVAL;
 	}
+
 	return error;
 }
 
 int link_data_list_set_second_tag_type(link_data_list_t *ld, char *name, char *second_tag_type)
 {
 	int error = 0;
-	int name_found = 0;
-
-	for (int i = 0; i < ld->count; i++) {
-		if (ld->links[i].name != NULL) {
-			if (strcmp(ld->links[i].name, name) == 0) {
-				name_found = 1;
-
-				if (ld->links[i].extensions.encapsulation.dot1q_vlan.second_tag_type  != NULL) {
-					FREE_SAFE(ld->links[i].extensions.encapsulation.dot1q_vlan.second_tag_type);
-				}
+	link_data_t *l = NULL;
 
-				unsigned long tmp_len = 0;
-				tmp_len = strlen(second_tag_type);
-				ld->links[i].extensions.encapsulation.dot1q_vlan.second_tag_type = xmalloc(sizeof(char) * (tmp_len + 1));
-				memcpy(ld->links[i].extensions.encapsulation.dot1q_vlan.second_tag_type, second_tag_type, tmp_len);
-				ld->links[i].extensions.encapsulation.dot1q_vlan.second_tag_type[tmp_len] = 0;
+	l = data_list_get_by_name(ld, name);
 
-				break;
-			}
+	if (l != NULL) {
+		if (l->extensions.encapsulation.dot1q_vlan.second_tag_type != NULL) {
+			FREE_SAFE(l->extensions.encapsulation.dot1q_vlan.second_tag_type);
 		}
-	}
-	if (!name_found) {
-		// error
+		l->extensions.encapsulation.dot1q_vlan.second_tag_type = xstrdup(second_tag_type);
+	} else {
 		error = EINVAL;
 	}
+
 	return error;
 }
 
@@ -632,7 +680,143 @@ void link_data_free(link_data_t *l)
 
 void link_data_list_free(link_data_list_t *ld)
 {
-	for (int i = 0; i < ld->count; i++) {
+	for (uint32_t i = 0; i < ld->count; i++) {
 		link_data_free(&ld->links[i]);
 	}
+
+	if (ld->links) {
+		FREE_SAFE(ld->links);
+	}
+
+	if (ld->free_list) {
+		FREE_SAFE(ld->free_list);
+	}
+
+	if (ld->name_index) {
+		FREE_SAFE(ld->name_index);
+	}
+
+	if (ld->ifindex_index) {
+		FREE_SAFE(ld->ifindex_index);
+	}
+
+	link_data_list_init(ld);
+}
+
+// FNV-1a
+static uint32_t link_data_name_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+
+	for (const unsigned char *ptr = (const unsigned char *) name; *ptr; ptr++) {
+		hash = (hash ^ *ptr) * 16777619u;
+	}
+
+	return hash;
+}
+
+// multiplicative hashing spreads consecutive indexes over the table
+static uint32_t link_data_ifindex_hash(int ifindex)
+{
+	return (uint32_t) ifindex * 2654435761u;
+}
+
+// returns the slot holding name or the empty slot where it would be inserted
+static uint32_t link_data_find_name_slot(link_data_list_t *ld, const char *name, uint32_t hash)
+{
+	const uint32_t MASK = ld->index_size - 1;
+	uint32_t slot = hash & MASK;
+
+	while (ld->name_index[slot].position != 0) {
+		const link_data_index_slot_t *ptr = &ld->name_index[slot];
+		if (ptr->hash == hash && strcmp(ld->links[ptr->position - 1].name, name) == 0) {
+			break;
+		}
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static uint32_t link_data_find_ifindex_slot(link_data_list_t *ld, int ifindex)
+{
+	const uint32_t MASK = ld->index_size - 1;
+	uint32_t slot = link_data_ifindex_hash(ifindex) & MASK;
+
+	while (ld->ifindex_index[slot].position != 0 && ld->links[ld->ifindex_index[slot].position - 1].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void link_data_index_insert(link_data_index_slot_t *index, uint32_t index_size, uint32_t hash, uint32_t position)
+{
+	const uint32_t MASK = index_size - 1;
+	uint32_t slot = hash & MASK;
+
+	while (index[slot].position != 0) {
+		slot = (slot + 1) & MASK;
+	}
+
+	index[slot].hash = hash;
+	index[slot].position = position + 1;
+}
+
+// backward shift deletion - no tombstones are left in the index
+static void link_data_index_remove(link_data_index_slot_t *index, uint32_t index_size, uint32_t slot)
+{
+	const uint32_t MASK = index_size - 1;
+	uint32_t hole = slot;
+	uint32_t next = slot;
+
+	index[hole].position = 0;
+
+	while (true) {
+		next = (next + 1) & MASK;
+		if (index[next].position == 0) {
+			break;
+		}
+
+		const uint32_t HOME = index[next].hash & MASK;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		index[hole] = index[next];
+		index[next].position = 0;
+		hole = next;
+	}
+}
+
+// both indexes are rebuilt from the links
+static void link_data_list_index_resize(link_data_list_t *ld, uint32_t index_size)
+{
+	if (ld->name_index) {
+		FREE_SAFE(ld->name_index);
+	}
+
+	if (ld->ifindex_index) {
+		FREE_SAFE(ld->ifindex_index);
+	}
+
+	ld->name_index = xcalloc(index_size, sizeof(link_data_index_slot_t));
+	ld->ifindex_index = xcalloc(index_size, sizeof(link_data_index_slot_t));
+	ld->index_size = index_size;
+
+	for (uint32_t i = 0; i < ld->count; i++) {
+		const link_data_t *l = &ld->links[i];
+
+		if (l->name == NULL) {
+			continue;
+		}
+
+		link_data_index_insert(ld->name_index, index_size, link_data_name_hash(l->name), i);
+		if (l->ifindex > 0) {
+			link_data_index_insert(ld->ifindex_index, index_size, link_data_ifindex_hash(l->ifindex), i);
+		}
+	}
 }
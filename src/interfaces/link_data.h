@@ -20,13 +20,13 @@
 #include "ipv4_data.h"
 #include "ipv6_data.h"
 
-#define LD_MAX_LINKS 100 // TODO: check this
-
 typedef struct link_data_s link_data_t;
+typedef struct link_data_index_slot_s link_data_index_slot_t;
 typedef struct link_data_list_s link_data_list_t;
 
 struct link_data_s {
 	char *name;
+	int ifindex; // 0 until the link is known to exist in the kernel
 	char *description;
 	char *type;
 	char *enabled;
@@ -49,9 +49,25 @@ struct link_data_s {
 	} extensions;
 };
 
+// index slot - position + 1 of the link in links, 0 marks an empty slot
+struct link_data_index_slot_s {
+	uint32_t hash;
+	uint32_t position;
+};
+
 struct link_data_list_s {
-	link_data_t links[LD_MAX_LINKS];
-	uint8_t count;
+	// removed links leave a hole (name == NULL) which is reused by the next add
+	link_data_t *links;
+	uint32_t count; // used positions, holes included
+	uint32_t capacity;
+
+	// open addressing (linear probing) indexes by name and by ifindex - power of two size, kept at most half full
+	link_data_index_slot_t *name_index;
+	link_data_index_slot_t *ifindex_index;
+	uint32_t index_size;
+
+	uint32_t *free_list;
+	uint32_t free_count;
 };
 
 // link_data struct functions
@@ -62,9 +78,12 @@ void link_data_free(link_data_t *l);
 // link_data_list functions - init
 int link_data_list_init(link_data_list_t *ld);
 int link_data_list_add(link_data_list_t *ld, char *name);
+int link_data_list_remove(link_data_list_t *ld, char *name);
 
 // basic options
 link_data_t *data_list_get_by_name(link_data_list_t *ld, char *name);
+link_data_t *data_list_get_by_ifindex(link_data_list_t *ld, int ifindex);
+int link_data_list_set_ifindex(link_data_list_t *ld, char *name, int ifindex);
 int link_data_list_set_description(link_data_list_t *ld, char *name, char *description);
 int link_data_list_set_type(link_data_list_t *ld, char *name, char *type);
 int link_data_list_set_enabled(link_data_list_t *ld, char *name, char *enabled);
@@ -0,0 +1,290 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "link_layers.h"
+#include "utils/memory.h"
+
+#define LINK_LAYERS_INITIAL_SIZE 64
+#define LINK_LAYER_EDGES_INITIAL_CAPACITY 4
+
+static link_layer_node_t *link_layers_lookup(const link_layers_t *ll, int ifindex);
+static unsigned int link_layers_find_slot(const link_layers_t *ll, int ifindex);
+static link_layer_node_t *link_layers_add(link_layers_t *ll, int ifindex);
+static void link_layers_drop_unused(link_layers_t *ll, int ifindex);
+static void link_layers_resize(link_layers_t *ll, unsigned int nodes_size);
+static void link_layers_edge_add(link_layers_t *ll, int target, bool members, int ifindex);
+static void link_layers_edge_remove(link_layers_t *ll, int target, bool members, int ifindex);
+
+void link_layers_init(link_layers_t *ll)
+{
+	ll->nodes = NULL;
+	ll->nodes_size = 0;
+	ll->count = 0;
+}
+
+void link_layers_set(link_layers_t *ll, int ifindex, const char *name, int master, int link)
+{
+	link_layer_node_t *node = NULL;
+	int old_master = 0;
+	int old_link = 0;
+
+	if (ifindex <= 0) {
+		return;
+	}
+
+	// physical links report themselves as their link
+	if (master == ifindex) {
+		master = 0;
+	}
+	if (link == ifindex) {
+		link = 0;
+	}
+
+	node = link_layers_add(ll, ifindex);
+
+	strncpy(node->name, name, sizeof(node->name) - 1);
+	node->name[sizeof(node->name) - 1] = '\0';
+
+	old_master = node->master;
+	old_link = node->link;
+	node->master = master;
+	node->link = link;
+
+	// adding an edge can grow the table - node isn't used past this point
+	if (old_master != master) {
+		link_layers_edge_remove(ll, old_master, true, ifindex);
+		link_layers_edge_add(ll, master, true, ifindex);
+	}
+
+	if (old_link != link) {
+		link_layers_edge_remove(ll, old_link, false, ifindex);
+		link_layers_edge_add(ll, link, false, ifindex);
+	}
+}
+
+// the node is kept without a name while other links still point to it - their events remove the edges
+void link_layers_remove(link_layers_t *ll, int ifindex)
+{
+	link_layer_node_t *node = link_layers_lookup(ll, ifindex);
+	int master = 0;
+	int link = 0;
+
+	if (node == NULL) {
+		return;
+	}
+
+	master = node->master;
+	link = node->link;
+	node->master = 0;
+	node->link = 0;
+	node->name[0] = '\0';
+
+	link_layers_edge_remove(ll, master, true, ifindex);
+	link_layers_edge_remove(ll, link, false, ifindex);
+	link_layers_drop_unused(ll, ifindex);
+}
+
+const link_layer_node_t *link_layers_get(const link_layers_t *ll, int ifindex)
+{
+	return link_layers_lookup(ll, ifindex);
+}
+
+const char *link_layers_get_name(const link_layers_t *ll, int ifindex)
+{
+	const link_layer_node_t *node = link_layers_lookup(ll, ifindex);
+
+	if (node == NULL || node->name[0] == '\0') {
+		return NULL;
+	}
+
+	return node->name;
+}
+
+void link_layers_free(link_layers_t *ll)
+{
+	for (unsigned int i = 0; i < ll->nodes_size; i++) {
+		if (ll->nodes[i].ifindex != 0) {
+			if (ll->nodes[i].members.data) {
+				FREE_SAFE(ll->nodes[i].members.data);
+			}
+			if (ll->nodes[i].stacked.data) {
+				FREE_SAFE(ll->nodes[i].stacked.data);
+			}
+		}
+	}
+
+	if (ll->nodes) {
+		FREE_SAFE(ll->nodes);
+	}
+
+	link_layers_init(ll);
+}
+
+static link_layer_node_t *link_layers_lookup(const link_layers_t *ll, int ifindex)
+{
+	unsigned int slot = 0;
+
+	if (ll->nodes_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = link_layers_find_slot(ll, ifindex);
+	if (ll->nodes[slot].ifindex == 0) {
+		return NULL;
+	}
+
+	return &ll->nodes[slot];
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static unsigned int link_layers_find_slot(const link_layers_t *ll, int ifindex)
+{
+	const unsigned int MASK = ll->nodes_size - 1;
+	unsigned int slot = ((uint32_t) ifindex * 2654435761u) & MASK;
+
+	while (ll->nodes[slot].ifindex != 0 && ll->nodes[slot].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+// returns the existing node of ifindex or a new empty one
+static link_layer_node_t *link_layers_add(link_layers_t *ll, int ifindex)
+{
+	link_layer_node_t *node = link_layers_lookup(ll, ifindex);
+
+	if (node != NULL) {
+		return node;
+	}
+
+	if ((ll->count + 1) * 2 > ll->nodes_size) {
+		link_layers_resize(ll, ll->nodes_size ? ll->nodes_size * 2 : LINK_LAYERS_INITIAL_SIZE);
+	}
+
+	node = &ll->nodes[link_layers_find_slot(ll, ifindex)];
+	memset(node, 0, sizeof(*node));
+	node->ifindex = ifindex;
+	ll->count += 1;
+
+	return node;
+}
+
+// remove the node of a link that is gone and no longer has any edges
+// backward shift deletion - no tombstones are left in the table
+static void link_layers_drop_unused(link_layers_t *ll, int ifindex)
+{
+	link_layer_node_t *node = link_layers_lookup(ll, ifindex);
+	unsigned int mask = 0;
+	unsigned int hole = 0;
+	unsigned int next = 0;
+
+	if (node == NULL || node->name[0] != '\0' || node->master != 0 || node->link != 0 || node->members.count != 0 || node->stacked.count != 0) {
+		return;
+	}
+
+	if (node->members.data) {
+		FREE_SAFE(node->members.data);
+	}
+	if (node->stacked.data) {
+		FREE_SAFE(node->stacked.data);
+	}
+
+	mask = ll->nodes_size - 1;
+	hole = (unsigned int) (node - ll->nodes);
+	ll->nodes[hole].ifindex = 0;
+	ll->count -= 1;
+
+	next = hole;
+	while (true) {
+		next = (next + 1) & mask;
+		if (ll->nodes[next].ifindex == 0) {
+			break;
+		}
+
+		const unsigned int HOME = ((uint32_t) ll->nodes[next].ifindex * 2654435761u) & mask;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		ll->nodes[hole] = ll->nodes[next];
+		ll->nodes[next].ifindex = 0;
+		hole = next;
+	}
+}
+
+static void link_layers_resize(link_layers_t *ll, unsigned int nodes_size)
+{
+	link_layer_node_t *old_nodes = ll->nodes;
+	const unsigned int OLD_SIZE = ll->nodes_size;
+
+	ll->nodes = xcalloc(nodes_size, sizeof(link_layer_node_t));
+	ll->nodes_size = nodes_size;
+
+	for (unsigned int i = 0; i < OLD_SIZE; i++) {
+		if (old_nodes[i].ifindex != 0) {
+			ll->nodes[link_layers_find_slot(ll, old_nodes[i].ifindex)] = old_nodes[i];
+		}
+	}
+
+	if (old_nodes) {
+		FREE_SAFE(old_nodes);
+	}
+}
+
+// record ifindex as a member (or a stacked link) of target - the target node is created if it isn't known yet
+static void link_layers_edge_add(link_layers_t *ll, int target, bool members, int ifindex)
+{
+	link_layer_node_t *node = NULL;
+	link_layer_edges_t *edges = NULL;
+
+	if (target <= 0) {
+		return;
+	}
+
+	node = link_layers_add(ll, target);
+	edges = members ? &node->members : &node->stacked;
+
+	if (edges->count == edges->capacity) {
+		edges->capacity = edges->capacity ? edges->capacity * 2 : LINK_LAYER_EDGES_INITIAL_CAPACITY;
+		edges->data = xrealloc(edges->data, sizeof(int) * edges->capacity);
+	}
+
+	edges->data[edges->count++] = ifindex;
+}
+
+static void link_layers_edge_remove(link_layers_t *ll, int target, bool members, int ifindex)
+{
+	link_layer_node_t *node = link_layers_lookup(ll, target);
+	link_layer_edges_t *edges = NULL;
+
+	if (node == NULL) {
+		return;
+	}
+
+	edges = members ? &node->members : &node->stacked;
+	for (unsigned int i = 0; i < edges->count; i++) {
+		if (edges->data[i] == ifindex) {
+			edges->data[i] = edges->data[--edges->count];
+			break;
+		}
+	}
+
+	link_layers_drop_unused(ll, target);
+}
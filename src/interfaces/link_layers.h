@@ -0,0 +1,64 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LINK_LAYERS_H_ONCE
+#define LINK_LAYERS_H_ONCE
+
+#include <net/if.h>
+
+typedef struct link_layer_edges_s link_layer_edges_t;
+typedef struct link_layer_node_s link_layer_node_t;
+typedef struct link_layers_s link_layers_t;
+
+// ifindexes of the links on the other side of the edges
+struct link_layer_edges_s {
+	int *data;
+	unsigned int count;
+	unsigned int capacity;
+};
+
+// layering of a single link
+// a link is below its master (bond, bridge ...) and above the link it is stacked on (vlan, macvlan ...)
+struct link_layer_node_s {
+	int ifindex; // 0 marks an empty slot
+	char name[IFNAMSIZ]; // empty while the link is only known from the edges of other links
+
+	// edges set by the link itself - 0 if not set
+	int master;
+	int link;
+
+	// reverse edges - links enslaved to this one and links stacked on top of it
+	link_layer_edges_t members;
+	link_layer_edges_t stacked;
+};
+
+// higher-layer-if/lower-layer-if index of all links
+// higher layers of a link are its master and stacked links, lower layers its link and members
+// updated per link event, so that the layers of a link are read in O(number of its edges)
+struct link_layers_s {
+	// open addressing (linear probing) table keyed by ifindex - power of two size, kept at most half full
+	link_layer_node_t *nodes;
+	unsigned int nodes_size;
+	unsigned int count;
+};
+
+void link_layers_init(link_layers_t *ll);
+// add or update a link - master and link are the ifindexes of its master and lower link, 0 if none
+void link_layers_set(link_layers_t *ll, int ifindex, const char *name, int master, int link);
+void link_layers_remove(link_layers_t *ll, int ifindex);
+const link_layer_node_t *link_layers_get(const link_layers_t *ll, int ifindex);
+// NULL for 0 and for links not (or no longer) present
+const char *link_layers_get_name(const link_layers_t *ll, int ifindex);
+void link_layers_free(link_layers_t *ll);
+
+#endif /* LINK_LAYERS_H_ONCE */
@@ -0,0 +1,176 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <netlink/errno.h>
+#include <netlink/route/addr.h>
+#include <netlink/route/neighbour.h>
+
+#include "link_snapshot.h"
+#include "utils/memory.h"
+
+#define LINK_SNAPSHOT_MIN_SIZE 64
+#define LINK_SNAPSHOT_OBJECTS_INITIAL_CAPACITY 4
+
+static link_snapshot_entry_t *link_snapshot_lookup(const link_snapshot_t *ls, int ifindex);
+static unsigned int link_snapshot_find_slot(const link_snapshot_t *ls, int ifindex);
+static void link_snapshot_objects_add(link_snapshot_objects_t *objects, struct nl_object *obj);
+
+void link_snapshot_init(link_snapshot_t *ls)
+{
+	ls->links = NULL;
+	ls->addrs = NULL;
+	ls->neighs = NULL;
+	ls->entries = NULL;
+	ls->entries_size = 0;
+	ls->count = 0;
+}
+
+int link_snapshot_load(link_snapshot_t *ls, struct nl_sock *socket, struct nl_cache *links)
+{
+	int error = 0;
+	unsigned int size = LINK_SNAPSHOT_MIN_SIZE;
+	struct nl_object *obj = NULL;
+	link_snapshot_entry_t *entry = NULL;
+
+	ls->links = nl_cache_clone(links);
+	if (ls->links == NULL) {
+		return -NLE_NOMEM;
+	}
+
+	error = rtnl_addr_alloc_cache(socket, &ls->addrs);
+	if (error != 0) {
+		return error;
+	}
+
+	error = rtnl_neigh_alloc_cache(socket, &ls->neighs);
+	if (error != 0) {
+		return error;
+	}
+
+	// the link count is known up front - the table is never resized
+	while (size < (unsigned int) nl_cache_nitems(ls->links) * 2) {
+		size *= 2;
+	}
+
+	ls->entries = xcalloc(size, sizeof(link_snapshot_entry_t));
+	ls->entries_size = size;
+
+	for (obj = nl_cache_get_first(ls->links); obj != NULL; obj = nl_cache_get_next(obj)) {
+		const int IFINDEX = rtnl_link_get_ifindex((struct rtnl_link *) obj);
+
+		if (IFINDEX <= 0) {
+			continue;
+		}
+
+		entry = &ls->entries[link_snapshot_find_slot(ls, IFINDEX)];
+		if (entry->ifindex != 0) {
+			continue;
+		}
+
+		entry->ifindex = IFINDEX;
+		entry->link = (struct rtnl_link *) obj;
+		ls->count += 1;
+	}
+
+	// addresses and neighbors of links that appeared after the link dump are left out
+	for (obj = nl_cache_get_first(ls->addrs); obj != NULL; obj = nl_cache_get_next(obj)) {
+		entry = link_snapshot_lookup(ls, rtnl_addr_get_ifindex((struct rtnl_addr *) obj));
+		if (entry != NULL) {
+			link_snapshot_objects_add(&entry->addrs, obj);
+		}
+	}
+
+	for (obj = nl_cache_get_first(ls->neighs); obj != NULL; obj = nl_cache_get_next(obj)) {
+		entry = link_snapshot_lookup(ls, rtnl_neigh_get_ifindex((struct rtnl_neigh *) obj));
+		if (entry != NULL) {
+			link_snapshot_objects_add(&entry->neighs, obj);
+		}
+	}
+
+	return 0;
+}
+
+const link_snapshot_entry_t *link_snapshot_get(const link_snapshot_t *ls, int ifindex)
+{
+	return link_snapshot_lookup(ls, ifindex);
+}
+
+void link_snapshot_free(link_snapshot_t *ls)
+{
+	for (unsigned int i = 0; i < ls->entries_size; i++) {
+		if (ls->entries[i].addrs.data) {
+			FREE_SAFE(ls->entries[i].addrs.data);
+		}
+		if (ls->entries[i].neighs.data) {
+			FREE_SAFE(ls->entries[i].neighs.data);
+		}
+	}
+
+	if (ls->entries) {
+		FREE_SAFE(ls->entries);
+	}
+
+	if (ls->links) {
+		nl_cache_free(ls->links);
+	}
+	if (ls->addrs) {
+		nl_cache_free(ls->addrs);
+	}
+	if (ls->neighs) {
+		nl_cache_free(ls->neighs);
+	}
+
+	link_snapshot_init(ls);
+}
+
+static link_snapshot_entry_t *link_snapshot_lookup(const link_snapshot_t *ls, int ifindex)
+{
+	unsigned int slot = 0;
+
+	if (ls->entries_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = link_snapshot_find_slot(ls, ifindex);
+	if (ls->entries[slot].ifindex == 0) {
+		return NULL;
+	}
+
+	return &ls->entries[slot];
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static unsigned int link_snapshot_find_slot(const link_snapshot_t *ls, int ifindex)
+{
+	const unsigned int MASK = ls->entries_size - 1;
+	unsigned int slot = ((uint32_t) ifindex * 2654435761u) & MASK;
+
+	while (ls->entries[slot].ifindex != 0 && ls->entries[slot].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void link_snapshot_objects_add(link_snapshot_objects_t *objects, struct nl_object *obj)
+{
+	if (objects->count == objects->capacity) {
+		objects->capacity = objects->capacity ? objects->capacity * 2 : LINK_SNAPSHOT_OBJECTS_INITIAL_CAPACITY;
+		objects->data = xrealloc(objects->data, sizeof(struct nl_object *) * objects->capacity);
+	}
+
+	objects->data[objects->count++] = obj;
+}
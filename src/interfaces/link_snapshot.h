@@ -0,0 +1,58 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LINK_SNAPSHOT_H_ONCE
+#define LINK_SNAPSHOT_H_ONCE
+
+#include <netlink/cache.h>
+#include <netlink/route/link.h>
+
+typedef struct link_snapshot_objects_s link_snapshot_objects_t;
+typedef struct link_snapshot_entry_s link_snapshot_entry_t;
+typedef struct link_snapshot_s link_snapshot_t;
+
+// addresses or neighbors of a single link - owned by the snapshot caches
+struct link_snapshot_objects_s {
+	struct nl_object **data;
+	unsigned int count;
+	unsigned int capacity;
+};
+
+struct link_snapshot_entry_s {
+	int ifindex; // 0 marks an empty slot
+	struct rtnl_link *link;
+	link_snapshot_objects_t addrs;
+	link_snapshot_objects_t neighs;
+};
+
+// links, addresses and neighbors at plugin startup, grouped by ifindex
+// every init stage reads this instead of dumping the kernel tables on its own
+struct link_snapshot_s {
+	struct nl_cache *links;
+	struct nl_cache *addrs;
+	struct nl_cache *neighs;
+
+	// open addressing (linear probing) table keyed by ifindex - sized once for the links, at most half full
+	link_snapshot_entry_t *entries;
+	unsigned int entries_size;
+	unsigned int count;
+};
+
+void link_snapshot_init(link_snapshot_t *ls);
+// links are copied from the given cache, addresses and neighbors are dumped once - returns a libnl error code
+int link_snapshot_load(link_snapshot_t *ls, struct nl_sock *socket, struct nl_cache *links);
+// NULL for links not present in the snapshot
+const link_snapshot_entry_t *link_snapshot_get(const link_snapshot_t *ls, int ifindex);
+void link_snapshot_free(link_snapshot_t *ls);
+
+#endif /* LINK_SNAPSHOT_H_ONCE */
@@ -0,0 +1,294 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+#include <netlink/netlink.h>
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+
+#include "link_stats.h"
+#include "utils/memory.h"
+
+#define LINK_STATS_INITIAL_CAPACITY 64
+
+static int link_stats_list_collect_cb(struct nl_msg *msg, void *arg);
+static unsigned int link_stats_list_find_slot(const link_stats_list_t *ls, int ifindex);
+static void link_stats_list_index_resize(link_stats_list_t *ls, unsigned int index_size);
+
+void link_stats_list_init(link_stats_list_t *ls)
+{
+	ls->data = NULL;
+	ls->count = 0;
+	ls->capacity = 0;
+	ls->index = NULL;
+	ls->index_size = 0;
+	ls->timestamp.tv_sec = 0;
+	ls->timestamp.tv_nsec = 0;
+}
+
+// returns the counters of ifindex - added zeroed if not in the list yet
+link_stats_t *link_stats_list_add(link_stats_list_t *ls, int ifindex)
+{
+	link_stats_t *st = link_stats_list_get(ls, ifindex);
+	unsigned int slot = 0;
+
+	if (st != NULL) {
+		return st;
+	}
+
+	if (ls->count == ls->capacity) {
+		ls->capacity = ls->capacity ? ls->capacity * 2 : LINK_STATS_INITIAL_CAPACITY;
+		ls->data = xrealloc(ls->data, sizeof(link_stats_t) * ls->capacity);
+	}
+
+	if ((ls->count + 1) * 2 > ls->index_size) {
+		link_stats_list_index_resize(ls, ls->index_size ? ls->index_size * 2 : LINK_STATS_INITIAL_CAPACITY * 2);
+	}
+
+	st = &ls->data[ls->count];
+	memset(st, 0, sizeof(*st));
+	st->ifindex = ifindex;
+
+	slot = link_stats_list_find_slot(ls, ifindex);
+	ls->index[slot] = ++ls->count;
+
+	return st;
+}
+
+link_stats_t *link_stats_list_get(const link_stats_list_t *ls, int ifindex)
+{
+	unsigned int slot = 0;
+
+	if (ls->index_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = link_stats_list_find_slot(ls, ifindex);
+	if (ls->index[slot] == 0) {
+		return NULL;
+	}
+
+	return &ls->data[ls->index[slot] - 1];
+}
+
+// drop all counters but keep the memory for the next collection
+void link_stats_list_clear(link_stats_list_t *ls)
+{
+	ls->count = 0;
+	if (ls->index) {
+		memset(ls->index, 0, sizeof(unsigned int) * ls->index_size);
+	}
+}
+
+// replaces the list contents with the current counters of all links (or only of ifindex if not 0)
+// a single RTM_GETSTATS dump filtered to IFLA_STATS_LINK_64 - only the counters are sent, no other link attributes
+int link_stats_list_collect(link_stats_list_t *ls, struct nl_sock *socket, int ifindex)
+{
+	int error = 0;
+	struct nl_msg *msg = NULL;
+	struct nl_cb *socket_cb = NULL;
+	struct nl_cb *cb = NULL;
+	struct if_stats_msg ifsm = {
+		.family = AF_UNSPEC,
+		.ifindex = ifindex > 0 ? (uint32_t) ifindex : 0,
+		.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64),
+	};
+
+	msg = nlmsg_alloc_simple(RTM_GETSTATS, ifindex > 0 ? 0 : NLM_F_DUMP);
+	if (msg == NULL) {
+		error = -NLE_NOMEM;
+		goto out;
+	}
+
+	error = nlmsg_append(msg, &ifsm, sizeof(ifsm), NLMSG_ALIGNTO);
+	if (error != 0) {
+		goto out;
+	}
+
+	// private callbacks - the socket ones are left as they are for the other users of the socket
+	socket_cb = nl_socket_get_cb(socket);
+	cb = nl_cb_clone(socket_cb);
+	if (cb == NULL) {
+		error = -NLE_NOMEM;
+		goto out;
+	}
+	nl_cb_set(cb, NL_CB_VALID, NL_CB_CUSTOM, link_stats_list_collect_cb, ls);
+
+	error = nl_send_auto(socket, msg);
+	if (error < 0) {
+		goto out;
+	}
+
+	link_stats_list_clear(ls);
+
+	error = nl_recvmsgs(socket, cb);
+
+	// a request for a single link is answered with the counters and an ack
+	if (error >= 0 && ifindex > 0) {
+		error = nl_wait_for_ack(socket);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ls->timestamp);
+
+out:
+	if (cb) {
+		nl_cb_put(cb);
+	}
+
+	if (socket_cb) {
+		nl_cb_put(socket_cb);
+	}
+
+	if (msg) {
+		nlmsg_free(msg);
+	}
+
+	return error < 0 ? error : 0;
+}
+
+// exponentially weighted moving averages of the traffic rates over each window (in seconds)
+// rate += (1 - e^(-dt / window)) * (sample - rate), with the rate of the first interval taken as is
+// a link missing from the previous collection or with counters going backwards (recreated link) starts over
+void link_stats_list_update_rates(link_stats_list_t *ls, const link_stats_list_t *previous, const unsigned int *windows, unsigned int window_count)
+{
+	const double DT = (double) (ls->timestamp.tv_sec - previous->timestamp.tv_sec) + (double) (ls->timestamp.tv_nsec - previous->timestamp.tv_nsec) / 1e9;
+	double alpha[LINK_STATS_MAX_RATE_WINDOWS] = {0};
+
+	if (window_count > LINK_STATS_MAX_RATE_WINDOWS) {
+		window_count = LINK_STATS_MAX_RATE_WINDOWS;
+	}
+
+	for (unsigned int i = 0; i < window_count; i++) {
+		alpha[i] = 1.0 - exp(-DT / (double) windows[i]);
+	}
+
+	for (unsigned int i = 0; i < ls->count; i++) {
+		link_stats_t *st = &ls->data[i];
+		const link_stats_t *prev = DT > 0 ? link_stats_list_get(previous, st->ifindex) : NULL;
+
+		st->has_rates = false;
+		memset(st->rates, 0, sizeof(st->rates));
+
+		if (prev == NULL || st->rx_bytes < prev->rx_bytes || st->tx_bytes < prev->tx_bytes || st->rx_packets < prev->rx_packets || st->tx_packets < prev->tx_packets) {
+			continue;
+		}
+
+		const link_rate_t SAMPLE = {
+			.in_bps = (double) (st->rx_bytes - prev->rx_bytes) * 8 / DT,
+			.in_pps = (double) (st->rx_packets - prev->rx_packets) / DT,
+			.out_bps = (double) (st->tx_bytes - prev->tx_bytes) * 8 / DT,
+			.out_pps = (double) (st->tx_packets - prev->tx_packets) / DT,
+		};
+
+		for (unsigned int j = 0; j < window_count; j++) {
+			link_rate_t *rate = &st->rates[j];
+
+			if (!prev->has_rates) {
+				*rate = SAMPLE;
+				continue;
+			}
+
+			rate->in_bps = prev->rates[j].in_bps + alpha[j] * (SAMPLE.in_bps - prev->rates[j].in_bps);
+			rate->in_pps = prev->rates[j].in_pps + alpha[j] * (SAMPLE.in_pps - prev->rates[j].in_pps);
+			rate->out_bps = prev->rates[j].out_bps + alpha[j] * (SAMPLE.out_bps - prev->rates[j].out_bps);
+			rate->out_pps = prev->rates[j].out_pps + alpha[j] * (SAMPLE.out_pps - prev->rates[j].out_pps);
+		}
+
+		st->has_rates = true;
+	}
+}
+
+void link_stats_list_free(link_stats_list_t *ls)
+{
+	if (ls->data) {
+		FREE_SAFE(ls->data);
+	}
+
+	if (ls->index) {
+		FREE_SAFE(ls->index);
+	}
+
+	link_stats_list_init(ls);
+}
+
+static int link_stats_list_collect_cb(struct nl_msg *msg, void *arg)
+{
+	link_stats_list_t *ls = (link_stats_list_t *) arg;
+	struct nlmsghdr *nlh = nlmsg_hdr(msg);
+	struct if_stats_msg *ifsm = NULL;
+	struct nlattr *tb[IFLA_STATS_MAX + 1];
+	struct rtnl_link_stats64 stats64 = {0};
+	link_stats_t *st = NULL;
+	size_t len = 0;
+
+	if (nlh->nlmsg_type != RTM_NEWSTATS || nlmsg_parse(nlh, sizeof(struct if_stats_msg), tb, IFLA_STATS_MAX, NULL) != 0) {
+		return NL_SKIP;
+	}
+
+	ifsm = nlmsg_data(nlh);
+	if (tb[IFLA_STATS_LINK_64] == NULL) {
+		return NL_SKIP;
+	}
+
+	// older kernels send a shorter struct - the missing counters stay 0
+	len = (size_t) nla_len(tb[IFLA_STATS_LINK_64]);
+	memcpy(&stats64, nla_data(tb[IFLA_STATS_LINK_64]), len < sizeof(stats64) ? len : sizeof(stats64));
+
+	st = link_stats_list_add(ls, (int) ifsm->ifindex);
+
+	st->rx_packets = stats64.rx_packets;
+	st->rx_bytes = stats64.rx_bytes;
+	st->rx_multicast = stats64.multicast;
+	st->rx_dropped = stats64.rx_dropped;
+	st->rx_errors = stats64.rx_errors;
+	// packets dropped for lack of a protocol handler
+	st->rx_unknown_protos = stats64.rx_nohandler;
+	st->tx_packets = stats64.tx_packets;
+	st->tx_bytes = stats64.tx_bytes;
+	st->tx_dropped = stats64.tx_dropped;
+	st->tx_errors = stats64.tx_errors;
+
+	return NL_OK;
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static unsigned int link_stats_list_find_slot(const link_stats_list_t *ls, int ifindex)
+{
+	const unsigned int MASK = ls->index_size - 1;
+	// multiplicative hashing spreads consecutive indexes over the table
+	unsigned int slot = (unsigned int) ifindex * 2654435761u & MASK;
+
+	while (ls->index[slot] != 0 && ls->data[ls->index[slot] - 1].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void link_stats_list_index_resize(link_stats_list_t *ls, unsigned int index_size)
+{
+	if (ls->index) {
+		FREE_SAFE(ls->index);
+	}
+
+	ls->index = xcalloc(index_size, sizeof(unsigned int));
+	ls->index_size = index_size;
+
+	for (unsigned int i = 0; i < ls->count; i++) {
+		ls->index[link_stats_list_find_slot(ls, ls->data[i].ifindex)] = i + 1;
+	}
+}
@@ -0,0 +1,83 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LINK_STATS_H_ONCE
+#define LINK_STATS_H_ONCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <netlink/socket.h>
+
+#include "if_nic_stats.h"
+
+#define LINK_STATS_MAX_RATE_WINDOWS 4
+
+typedef struct link_rate_s link_rate_t;
+typedef struct link_stats_s link_stats_t;
+typedef struct link_stats_list_s link_stats_list_t;
+
+// traffic rates of a link averaged over one window
+struct link_rate_s {
+	double in_bps;
+	double in_pps;
+	double out_bps;
+	double out_pps;
+};
+
+// kernel counters of a single link
+struct link_stats_s {
+	int ifindex;
+	uint64_t rx_packets;
+	uint64_t rx_bytes;
+	uint64_t rx_multicast;
+	uint64_t rx_dropped;
+	uint64_t rx_errors;
+	uint64_t rx_unknown_protos;
+	uint64_t tx_packets;
+	uint64_t tx_bytes;
+	uint64_t tx_dropped;
+	uint64_t tx_errors;
+
+	// ethtool counters - filled in by the caller of link_stats_list_collect()
+	nic_stats_t nic;
+
+	// filled in by link_stats_list_update_rates() - has_rates is false for a link seen for the first time
+	bool has_rates;
+	link_rate_t rates[LINK_STATS_MAX_RATE_WINDOWS];
+};
+
+// counters of all links, looked up by ifindex
+struct link_stats_list_s {
+	link_stats_t *data;
+	unsigned int count;
+	unsigned int capacity;
+
+	// open addressing (linear probing) index by ifindex - position + 1 of the counters in data, 0 marks an empty slot
+	// power of two size, kept at most half full
+	unsigned int *index;
+	unsigned int index_size;
+
+	// CLOCK_MONOTONIC time of the collection
+	struct timespec timestamp;
+};
+
+void link_stats_list_init(link_stats_list_t *ls);
+link_stats_t *link_stats_list_add(link_stats_list_t *ls, int ifindex);
+link_stats_t *link_stats_list_get(const link_stats_list_t *ls, int ifindex);
+void link_stats_list_clear(link_stats_list_t *ls);
+int link_stats_list_collect(link_stats_list_t *ls, struct nl_sock *socket, int ifindex);
+void link_stats_list_update_rates(link_stats_list_t *ls, const link_stats_list_t *previous, const unsigned int *windows, unsigned int window_count);
+void link_stats_list_free(link_stats_list_t *ls);
+
+#endif /* LINK_STATS_H_ONCE */
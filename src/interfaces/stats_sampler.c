@@ -0,0 +1,215 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include <sysrepo.h>
+
+#include "stats_sampler.h"
+
+static void *stats_sampler_thread_cb(void *data);
+static int stats_sampler_sample(stats_sampler_t *sampler);
+
+void stats_sampler_init(stats_sampler_t *sampler)
+{
+	link_stats_list_init(&sampler->buffers[0]);
+	link_stats_list_init(&sampler->buffers[1]);
+	sampler->front = 0;
+	pthread_rwlock_init(&sampler->lock, NULL);
+
+	sampler->interval_ms = 0;
+	sampler->collect = NULL;
+	sampler->arg = NULL;
+	sampler->rate_window_count = 0;
+
+	sampler->timer_fd = -1;
+	sampler->wakeup_fd = -1;
+	sampler->running = false;
+}
+
+void stats_sampler_set_rate_windows(stats_sampler_t *sampler, const unsigned int *windows, unsigned int count)
+{
+	if (count > LINK_STATS_MAX_RATE_WINDOWS) {
+		count = LINK_STATS_MAX_RATE_WINDOWS;
+	}
+
+	memcpy(sampler->rate_windows, windows, sizeof(unsigned int) * count);
+	sampler->rate_window_count = count;
+}
+
+int stats_sampler_start(stats_sampler_t *sampler, unsigned int interval_ms, stats_sampler_collect_cb collect, void *arg)
+{
+	int error = 0;
+	struct itimerspec timer = {0};
+
+	sampler->interval_ms = interval_ms;
+	sampler->collect = collect;
+	sampler->arg = arg;
+
+	error = stats_sampler_sample(sampler);
+	if (error != 0) {
+		SRP_LOG_ERR("stats_sampler_sample error (%d)", error);
+		goto error_out;
+	}
+
+	sampler->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (sampler->timer_fd == -1) {
+		SRP_LOG_ERR("timerfd_create error: %s", strerror(errno));
+		goto error_out;
+	}
+
+	// fixed rate - the interval doesn't drift by the time spent collecting
+	timer.it_interval.tv_sec = interval_ms / 1000;
+	timer.it_interval.tv_nsec = (long) (interval_ms % 1000) * 1000000;
+	timer.it_value = timer.it_interval;
+	if (timerfd_settime(sampler->timer_fd, 0, &timer, NULL) == -1) {
+		SRP_LOG_ERR("timerfd_settime error: %s", strerror(errno));
+		goto error_out;
+	}
+
+	sampler->wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (sampler->wakeup_fd == -1) {
+		SRP_LOG_ERR("eventfd error: %s", strerror(errno));
+		goto error_out;
+	}
+
+	error = pthread_create(&sampler->thread, NULL, stats_sampler_thread_cb, sampler);
+	if (error != 0) {
+		SRP_LOG_ERR("pthread_create error (%d)", error);
+		goto error_out;
+	}
+
+	sampler->running = true;
+
+	return 0;
+
+error_out:
+	if (sampler->timer_fd != -1) {
+		close(sampler->timer_fd);
+		sampler->timer_fd = -1;
+	}
+
+	if (sampler->wakeup_fd != -1) {
+		close(sampler->wakeup_fd);
+		sampler->wakeup_fd = -1;
+	}
+
+	return -1;
+}
+
+// the returned snapshot stays valid until stats_sampler_release()
+const link_stats_list_t *stats_sampler_acquire(stats_sampler_t *sampler)
+{
+	pthread_rwlock_rdlock(&sampler->lock);
+
+	return &sampler->buffers[sampler->front];
+}
+
+void stats_sampler_release(stats_sampler_t *sampler)
+{
+	pthread_rwlock_unlock(&sampler->lock);
+}
+
+void stats_sampler_stop(stats_sampler_t *sampler)
+{
+	if (sampler->running) {
+		if (eventfd_write(sampler->wakeup_fd, 1) == 0) {
+			pthread_join(sampler->thread, NULL);
+		}
+		sampler->running = false;
+	}
+
+	if (sampler->timer_fd != -1) {
+		close(sampler->timer_fd);
+		sampler->timer_fd = -1;
+	}
+
+	if (sampler->wakeup_fd != -1) {
+		close(sampler->wakeup_fd);
+		sampler->wakeup_fd = -1;
+	}
+
+	link_stats_list_free(&sampler->buffers[0]);
+	link_stats_list_free(&sampler->buffers[1]);
+	pthread_rwlock_destroy(&sampler->lock);
+}
+
+static void *stats_sampler_thread_cb(void *data)
+{
+	stats_sampler_t *sampler = (stats_sampler_t *) data;
+	struct pollfd fds[2] = {
+		{.fd = sampler->timer_fd, .events = POLLIN},
+		{.fd = sampler->wakeup_fd, .events = POLLIN},
+	};
+	uint64_t expirations = 0;
+	int error = 0;
+
+	while (true) {
+		if (poll(fds, 2, -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			SRP_LOG_ERR("poll error: %s", strerror(errno));
+			break;
+		}
+
+		if (fds[1].revents & POLLIN) {
+			break;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			// missed expirations are dropped - one snapshot per wakeup is enough
+			if (read(sampler->timer_fd, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN) {
+				SRP_LOG_ERR("read error: %s", strerror(errno));
+				break;
+			}
+
+			error = stats_sampler_sample(sampler);
+			if (error != 0) {
+				SRP_LOG_ERR("stats_sampler_sample error (%d) - keeping the previous snapshot", error);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// only the sampler thread (or stats_sampler_start() before it) writes to the back buffer - no lock is needed to fill it
+// nor to read the front one, which only this thread swaps
+static int stats_sampler_sample(stats_sampler_t *sampler)
+{
+	const unsigned int BACK = sampler->front ^ 1;
+	int error = 0;
+
+	error = sampler->collect(&sampler->buffers[BACK], sampler->arg);
+	if (error != 0) {
+		return error;
+	}
+
+	// the rates are carried over from the previous snapshot
+	if (sampler->rate_window_count > 0) {
+		link_stats_list_update_rates(&sampler->buffers[BACK], &sampler->buffers[sampler->front], sampler->rate_windows, sampler->rate_window_count);
+	}
+
+	pthread_rwlock_wrlock(&sampler->lock);
+	sampler->front = BACK;
+	pthread_rwlock_unlock(&sampler->lock);
+
+	return 0;
+}
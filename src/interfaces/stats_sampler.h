@@ -0,0 +1,58 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STATS_SAMPLER_H_ONCE
+#define STATS_SAMPLER_H_ONCE
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "link_stats.h"
+
+typedef struct stats_sampler_s stats_sampler_t;
+
+// fills the list with the current counters of all links - called from the sampler thread
+typedef int (*stats_sampler_collect_cb)(link_stats_list_t *ls, void *arg);
+
+// background thread taking a snapshot of the counters of all links every interval_ms
+// snapshots are double buffered - the thread collects into the back buffer and swaps it with the front one
+// under the write lock, readers hold the read lock while using the front buffer
+struct stats_sampler_s {
+	link_stats_list_t buffers[2];
+	unsigned int front;
+	pthread_rwlock_t lock;
+
+	unsigned int interval_ms;
+	stats_sampler_collect_cb collect;
+	void *arg;
+
+	// averaging windows of the rate estimates in seconds - no rates are estimated if rate_window_count is 0
+	unsigned int rate_windows[LINK_STATS_MAX_RATE_WINDOWS];
+	unsigned int rate_window_count;
+
+	pthread_t thread;
+	int timer_fd;
+	int wakeup_fd;
+	bool running;
+};
+
+void stats_sampler_init(stats_sampler_t *sampler);
+// called before stats_sampler_start()
+void stats_sampler_set_rate_windows(stats_sampler_t *sampler, const unsigned int *windows, unsigned int count);
+// takes the first snapshot before returning - the front buffer is valid as soon as the sampler is running
+int stats_sampler_start(stats_sampler_t *sampler, unsigned int interval_ms, stats_sampler_collect_cb collect, void *arg);
+const link_stats_list_t *stats_sampler_acquire(stats_sampler_t *sampler);
+void stats_sampler_release(stats_sampler_t *sampler);
+void stats_sampler_stop(stats_sampler_t *sampler);
+
+#endif /* STATS_SAMPLER_H_ONCE */
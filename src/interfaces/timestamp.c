@@ -0,0 +1,150 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "timestamp.h"
+
+static int timestamp_cache_arm(timestamp_cache_t *tc);
+static int timestamp_cache_render(timestamp_cache_t *tc);
+
+int timestamp_cache_init(timestamp_cache_t *tc)
+{
+	memset(tc->boot_time, 0, sizeof(tc->boot_time));
+
+	if (pthread_mutex_init(&tc->lock, NULL) != 0) {
+		tc->timer_fd = -1;
+		return -1;
+	}
+
+	tc->timer_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (tc->timer_fd == -1) {
+		goto error_out;
+	}
+
+	// armed before rendering - a clock change in between is not missed
+	if (timestamp_cache_arm(tc) != 0 || timestamp_cache_render(tc) != 0) {
+		goto error_out;
+	}
+
+	return 0;
+
+error_out:
+	if (tc->timer_fd != -1) {
+		close(tc->timer_fd);
+		tc->timer_fd = -1;
+	}
+	pthread_mutex_destroy(&tc->lock);
+
+	return -1;
+}
+
+// called when timer_fd is readable - the realtime clock was set, so the boot time moved
+int timestamp_cache_refresh(timestamp_cache_t *tc)
+{
+	uint64_t expirations = 0;
+
+	// fails with ECANCELED after a clock change, which also disarms the timer
+	if (read(tc->timer_fd, &expirations, sizeof(expirations)) == -1 && errno != ECANCELED && errno != EAGAIN) {
+		return -1;
+	}
+
+	if (timestamp_cache_arm(tc) != 0) {
+		return -1;
+	}
+
+	return timestamp_cache_render(tc);
+}
+
+void timestamp_cache_get_boot_time(timestamp_cache_t *tc, char boot_time[TIMESTAMP_BUF_SIZE])
+{
+	pthread_mutex_lock(&tc->lock);
+	memcpy(boot_time, tc->boot_time, TIMESTAMP_BUF_SIZE);
+	pthread_mutex_unlock(&tc->lock);
+}
+
+void timestamp_cache_free(timestamp_cache_t *tc)
+{
+	if (tc->timer_fd != -1) {
+		close(tc->timer_fd);
+		tc->timer_fd = -1;
+		pthread_mutex_destroy(&tc->lock);
+	}
+}
+
+int timestamp_format(time_t when, char buffer[TIMESTAMP_BUF_SIZE])
+{
+	struct tm ts = {0};
+
+	if (localtime_r(&when, &ts) == NULL) {
+		return -1;
+	}
+
+	/* must satisfy constraint (type yang:date-and-time):
+		"\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d+)?(Z|[\+\-]\d{2}:\d{2})"
+	*/
+	if (strftime(buffer, TIMESTAMP_BUF_SIZE, "%FT%TZ", &ts) == 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+// absolute expiry far ahead of the current time - the timer is only meant to fire by being cancelled on a clock change
+// if it ever expires, refresh re-arms it relative to the new time, so it can't stay expired
+static int timestamp_cache_arm(timestamp_cache_t *tc)
+{
+	const time_t HORIZON = (time_t) 10 * 365 * 24 * 60 * 60;
+	struct itimerspec timer = {0};
+	struct timespec now = {0};
+
+	if (clock_gettime(CLOCK_REALTIME, &now) != 0) {
+		return -1;
+	}
+
+	// a 32-bit time_t can't go past 2038 - keep the furthest representable value instead of wrapping
+	if (sizeof(time_t) < sizeof(int64_t) && now.tv_sec > (time_t) (INT32_MAX - HORIZON)) {
+		timer.it_value.tv_sec = (time_t) INT32_MAX;
+	} else {
+		timer.it_value.tv_sec = now.tv_sec + HORIZON;
+	}
+
+	return timerfd_settime(tc->timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &timer, NULL);
+}
+
+// boot time = realtime now - time since boot (including suspend)
+static int timestamp_cache_render(timestamp_cache_t *tc)
+{
+	struct timespec now = {0};
+	struct timespec uptime = {0};
+	char boot_time[TIMESTAMP_BUF_SIZE] = {0};
+
+	if (clock_gettime(CLOCK_REALTIME, &now) != 0 || clock_gettime(CLOCK_BOOTTIME, &uptime) != 0) {
+		return -1;
+	}
+
+	if (timestamp_format(now.tv_sec - uptime.tv_sec, boot_time) != 0) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&tc->lock);
+	memcpy(tc->boot_time, boot_time, sizeof(boot_time));
+	pthread_mutex_unlock(&tc->lock);
+
+	return 0;
+}
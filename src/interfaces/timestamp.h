@@ -0,0 +1,41 @@
+/*
+ * telekom / sysrepo-plugin-interfaces
+ *
+ * This program is made available under the terms of the
+ * BSD 3-Clause license which is available at
+ * https://opensource.org/licenses/BSD-3-Clause
+ *
+ * SPDX-FileCopyrightText: 2021 Deutsche Telekom AG
+ * SPDX-FileContributor: Sartura Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TIMESTAMP_H_ONCE
+#define TIMESTAMP_H_ONCE
+
+#include <pthread.h>
+#include <time.h>
+
+// fits "%FT%TZ" (yang:date-and-time)
+#define TIMESTAMP_BUF_SIZE 30
+
+typedef struct timestamp_cache_s timestamp_cache_t;
+
+// boot time rendered once and rendered again only when the realtime clock is set
+// timer_fd becomes readable on clock changes - whoever polls it calls timestamp_cache_refresh()
+struct timestamp_cache_s {
+	pthread_mutex_t lock;
+	char boot_time[TIMESTAMP_BUF_SIZE];
+	int timer_fd;
+};
+
+int timestamp_cache_init(timestamp_cache_t *tc);
+int timestamp_cache_refresh(timestamp_cache_t *tc);
+void timestamp_cache_get_boot_time(timestamp_cache_t *tc, char boot_time[TIMESTAMP_BUF_SIZE]);
+void timestamp_cache_free(timestamp_cache_t *tc);
+
+// thread safe rendering of a point in time as yang:date-and-time
+int timestamp_format(time_t when, char buffer[TIMESTAMP_BUF_SIZE]);
+
+#endif /* TIMESTAMP_H_ONCE */
@@ -0,0 +1,141 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "link_names.h"
+#include "utils/memory.h"
+
+#define LINK_NAMES_INITIAL_SIZE 64
+
+static size_t link_names_find_slot(const struct link_names *names, int ifindex);
+static void link_names_resize(struct link_names *names, size_t table_size);
+
+void link_names_init(struct link_names *names)
+{
+	names->table = NULL;
+	names->table_size = 0;
+	names->count = 0;
+}
+
+// add a new name or replace the name of an existing index (link renamed)
+void link_names_set(struct link_names *names, int ifindex, const char *name)
+{
+	size_t slot = 0;
+
+	if (ifindex <= 0 || name == NULL) {
+		return;
+	}
+
+	if ((names->count + 1) * 2 > names->table_size) {
+		link_names_resize(names, names->table_size ? names->table_size * 2 : LINK_NAMES_INITIAL_SIZE);
+	}
+
+	slot = link_names_find_slot(names, ifindex);
+	if (names->table[slot].ifindex == 0) {
+		names->table[slot].ifindex = ifindex;
+		names->count += 1;
+	}
+
+	strncpy(names->table[slot].name, name, IFNAMSIZ - 1);
+	names->table[slot].name[IFNAMSIZ - 1] = 0;
+}
+
+// backward shift deletion - no tombstones are left in the table
+void link_names_remove(struct link_names *names, int ifindex)
+{
+	size_t mask = 0;
+	size_t hole = 0;
+	size_t next = 0;
+
+	if (names->table_size == 0) {
+		return;
+	}
+
+	hole = link_names_find_slot(names, ifindex);
+	if (names->table[hole].ifindex == 0) {
+		return;
+	}
+
+	mask = names->table_size - 1;
+	names->table[hole].ifindex = 0;
+	names->count -= 1;
+	next = hole;
+
+	while (true) {
+		next = (next + 1) & mask;
+		if (names->table[next].ifindex == 0) {
+			break;
+		}
+
+		const size_t HOME = (uint32_t) names->table[next].ifindex * 2654435761u & mask;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		names->table[hole] = names->table[next];
+		names->table[next].ifindex = 0;
+		hole = next;
+	}
+}
+
+// returns NULL for an unknown index
+const char *link_names_get(const struct link_names *names, int ifindex)
+{
+	size_t slot = 0;
+
+	if (names->table_size == 0 || ifindex <= 0) {
+		return NULL;
+	}
+
+	slot = link_names_find_slot(names, ifindex);
+	if (names->table[slot].ifindex == 0) {
+		return NULL;
+	}
+
+	return names->table[slot].name;
+}
+
+void link_names_free(struct link_names *names)
+{
+	if (names->table) {
+		FREE_SAFE(names->table);
+	}
+
+	link_names_init(names);
+}
+
+// returns the slot holding ifindex or the empty slot where it would be inserted
+static size_t link_names_find_slot(const struct link_names *names, int ifindex)
+{
+	const size_t MASK = names->table_size - 1;
+	// multiplicative hashing spreads consecutive indexes over the table
+	size_t slot = (uint32_t) ifindex * 2654435761u & MASK;
+
+	while (names->table[slot].ifindex != 0 && names->table[slot].ifindex != ifindex) {
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void link_names_resize(struct link_names *names, size_t table_size)
+{
+	struct link_names_slot *old_table = names->table;
+	const size_t OLD_SIZE = names->table_size;
+
+	names->table = xcalloc(table_size, sizeof(struct link_names_slot));
+	names->table_size = table_size;
+
+	for (size_t i = 0; i < OLD_SIZE; i++) {
+		if (old_table[i].ifindex != 0) {
+			const size_t SLOT = link_names_find_slot(names, old_table[i].ifindex);
+			names->table[SLOT] = old_table[i];
+		}
+	}
+
+	if (old_table) {
+		FREE_SAFE(old_table);
+	}
+}
@@ -0,0 +1,27 @@
+#ifndef ROUTING_LINK_NAMES_H
+#define ROUTING_LINK_NAMES_H
+
+#include <stddef.h>
+#include <net/if.h>
+
+// index slot - ifindex 0 is never used by the kernel and marks an empty slot
+struct link_names_slot {
+	int ifindex;
+	char name[IFNAMSIZ];
+};
+
+// struct maps interface indexes to interface names
+// open addressing (linear probing) table - power of two size, kept at most half full
+struct link_names {
+	struct link_names_slot *table;
+	size_t table_size;
+	size_t count;
+};
+
+void link_names_init(struct link_names *names);
+void link_names_set(struct link_names *names, int ifindex, const char *name);
+void link_names_remove(struct link_names *names, int ifindex);
+const char *link_names_get(const struct link_names *names, int ifindex);
+void link_names_free(struct link_names *names);
+
+#endif // ROUTING_LINK_NAMES_H
@@ -1,3 +1,4 @@
+#include <arpa/inet.h>
 #include <net/if.h>
 #include <string.h>
 #include <stdlib.h>
@@ -17,6 +18,7 @@ void rib_init(struct rib *rib)
 	memset(rib->description, 0, sizeof(rib->description));
 
 	route_list_hash_init(&rib->routes);
+	rib_trie_init(&rib->trie);
 }
 
 void rib_set_address_family(struct rib *rib, int af)
@@ -39,7 +41,79 @@ void rib_set_name(struct rib *rib, char *buff)
 	memcpy(rib->name, buff, strlen(buff));
 }
 
+void rib_add_route(struct rib *rib, struct nl_addr *dst, struct route *route)
+{
+	struct route_list *ls = NULL;
+
+	route_list_hash_add(&rib->routes, dst, route);
+
+	// positions in the hash don't change until pruned - safe to keep in the trie
+	ls = route_list_hash_get_by_addr(&rib->routes, dst);
+	rib_trie_insert(&rib->trie, dst, (size_t) (ls - rib->routes.list_route));
+
+	route_list_update_active(ls);
+}
+
+// remove the route with the given preference (metric), tos and type - the prefix is removed with its last route
+void rib_remove_route(struct rib *rib, struct nl_addr *dst, uint32_t preference, uint8_t tos, uint8_t type)
+{
+	struct route_list *ls = route_list_hash_get_by_addr(&rib->routes, dst);
+
+	if (ls == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < ls->size; i++) {
+		const struct route *ROUTE = &ls->list[i];
+
+		if (ROUTE->preference == preference && ROUTE->tos == tos && ROUTE->type == type) {
+			route_list_remove(ls, i);
+			break;
+		}
+	}
+
+	if (ls->size == 0) {
+		rib_trie_remove(&rib->trie, dst);
+		route_list_hash_remove(&rib->routes, dst);
+	} else {
+		route_list_update_active(ls);
+	}
+}
+
+// longest prefix match of addr - returns the routes of the matching prefix and the prefix itself
+struct route_list *rib_lookup_route_list(struct rib *rib, struct nl_addr *addr, struct nl_addr **prefix)
+{
+	size_t position = 0;
+
+	if (rib_trie_lookup(&rib->trie, addr, &position) != 0) {
+		return NULL;
+	}
+
+	if (prefix) {
+		*prefix = rib->routes.list_addr[position];
+	}
+
+	return &rib->routes.list_route[position];
+}
+
+// prefix in the destination-prefix format - libnl writes neither the default route prefix nor a full length prefix length
+void rib_prefix_to_str(struct nl_addr *prefix, int family, char *buffer, size_t buffer_size)
+{
+	char ip_buffer[INET6_ADDRSTRLEN] = {0};
+
+	nl_addr2str(prefix, ip_buffer, sizeof(ip_buffer));
+
+	if (strncmp(ip_buffer, "none", sizeof("none") - 1) == 0) {
+		snprintf(buffer, buffer_size, "%s", family == AF_INET ? "0.0.0.0/0" : "::/0");
+	} else if (strchr(ip_buffer, '/') == NULL) {
+		snprintf(buffer, buffer_size, "%s/%u", ip_buffer, nl_addr_get_prefixlen(prefix));
+	} else {
+		snprintf(buffer, buffer_size, "%s", ip_buffer);
+	}
+}
+
 void rib_free(struct rib *rib)
 {
 	route_list_hash_free(&rib->routes);
+	rib_trie_free(&rib->trie);
 }
@@ -3,6 +3,7 @@
 
 #include "route/list_hash.h"
 #include "rib/description_pair.h"
+#include "rib/trie.h"
 
 struct rib {
 	char name[32];
@@ -10,6 +11,8 @@ struct rib {
 	int address_family;
 	int default_rib;
 	struct route_list_hash routes;
+	// longest prefix match index over the routes hash
+	struct rib_trie trie;
 };
 
 void rib_init(struct rib *rib);
@@ -17,6 +20,12 @@ void rib_set_address_family(struct rib *rib, int af);
 void rib_set_description(struct rib *rib, const char *desc);
 void rib_set_default(struct rib *rib, int def);
 void rib_set_name(struct rib *rib, char *buff);
+// moves the route into the RIB (see route_list_add())
+void rib_add_route(struct rib *rib, struct nl_addr *dst, struct route *route);
+// the RIB holds the routes of a single table - within it a route is identified by its preference, tos and type
+void rib_remove_route(struct rib *rib, struct nl_addr *dst, uint32_t preference, uint8_t tos, uint8_t type);
+struct route_list *rib_lookup_route_list(struct rib *rib, struct nl_addr *addr, struct nl_addr **prefix);
+void rib_prefix_to_str(struct nl_addr *prefix, int family, char *buffer, size_t buffer_size);
 void rib_free(struct rib *rib);
 
 #endif // ROUTING_RIB_H
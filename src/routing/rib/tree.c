@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netlink/addr.h>
+#include <sysrepo.h>
+
+#include "rib.h"
+#include "rib/tree.h"
+
+#define RIB_TREE_ROUTE_YANG_PATH "/ietf-routing:routing/ribs/rib/routes/route"
+#define RIB_TREE_NEXT_HOP_YANG_PATH RIB_TREE_ROUTE_YANG_PATH "/next-hop"
+#define RIB_TREE_NEXT_HOP_LIST_YANG_PATH RIB_TREE_NEXT_HOP_YANG_PATH "/next-hop-list/next-hop"
+
+static inline LY_ERR rib_tree_new_inner(struct lyd_node *parent, const struct lysc_node *schema, struct lyd_node **node);
+static inline LY_ERR rib_tree_new_list(struct lyd_node *parent, const struct lysc_node *schema, struct lyd_node **node);
+static inline LY_ERR rib_tree_new_term(struct lyd_node *parent, const struct lysc_node *schema, const char *value);
+static int rib_tree_add_next_hop(const struct rib_tree_schema *schema, struct lyd_node *route_node, size_t af, const struct route_next_hop *next_hop, const struct link_names *names);
+
+int rib_tree_schema_init(struct rib_tree_schema *schema, const struct ly_ctx *ly_ctx)
+{
+	const struct {
+		const struct lysc_node **node;
+		const char *path;
+		bool optional;
+	} NODES[] = {
+		{&schema->route, RIB_TREE_ROUTE_YANG_PATH, false},
+		{&schema->route_preference, RIB_TREE_ROUTE_YANG_PATH "/route-preference", false},
+		{&schema->next_hop, RIB_TREE_NEXT_HOP_YANG_PATH, false},
+		{&schema->outgoing_interface, RIB_TREE_NEXT_HOP_YANG_PATH "/outgoing-interface", false},
+		{&schema->special_next_hop, RIB_TREE_NEXT_HOP_YANG_PATH "/special-next-hop", false},
+		{&schema->next_hop_list, RIB_TREE_NEXT_HOP_YANG_PATH "/next-hop-list", false},
+		{&schema->next_hop_list_next_hop, RIB_TREE_NEXT_HOP_LIST_YANG_PATH, false},
+		{&schema->next_hop_list_outgoing_interface, RIB_TREE_NEXT_HOP_LIST_YANG_PATH "/outgoing-interface", false},
+		{&schema->source_protocol, RIB_TREE_ROUTE_YANG_PATH "/source-protocol", false},
+		{&schema->active, RIB_TREE_ROUTE_YANG_PATH "/active", false},
+		{&schema->destination_prefix[ROUTING_RIB_TREE_AF_IPV4], RIB_TREE_ROUTE_YANG_PATH "/ietf-ipv4-unicast-routing:destination-prefix", true},
+		{&schema->destination_prefix[ROUTING_RIB_TREE_AF_IPV6], RIB_TREE_ROUTE_YANG_PATH "/ietf-ipv6-unicast-routing:destination-prefix", true},
+		{&schema->next_hop_address[ROUTING_RIB_TREE_AF_IPV4], RIB_TREE_NEXT_HOP_YANG_PATH "/ietf-ipv4-unicast-routing:next-hop-address", true},
+		{&schema->next_hop_address[ROUTING_RIB_TREE_AF_IPV6], RIB_TREE_NEXT_HOP_YANG_PATH "/ietf-ipv6-unicast-routing:next-hop-address", true},
+		{&schema->next_hop_list_address[ROUTING_RIB_TREE_AF_IPV4], RIB_TREE_NEXT_HOP_LIST_YANG_PATH "/ietf-ipv4-unicast-routing:address", true},
+		{&schema->next_hop_list_address[ROUTING_RIB_TREE_AF_IPV6], RIB_TREE_NEXT_HOP_LIST_YANG_PATH "/ietf-ipv6-unicast-routing:address", true},
+	};
+
+	memset(schema, 0, sizeof(*schema));
+
+	for (size_t i = 0; i < sizeof(NODES) / sizeof(NODES[0]); i++) {
+		*NODES[i].node = lys_find_path(ly_ctx, NULL, NODES[i].path, 0);
+		if (*NODES[i].node == NULL && !NODES[i].optional) {
+			SRP_LOG_ERR("unable to find schema node %s", NODES[i].path);
+			memset(schema, 0, sizeof(*schema));
+			return -1;
+		}
+	}
+
+	schema->ly_ctx = ly_ctx;
+
+	return 0;
+}
+
+// add all routes of a prefix to the routes container of a RIB
+int rib_tree_add_route_list(const struct rib_tree_schema *schema, struct lyd_node *routes_node, int family, struct nl_addr *prefix, const struct route_list *routes, const struct link_names *names)
+{
+	const size_t AF = family == AF_INET ? ROUTING_RIB_TREE_AF_IPV4 : ROUTING_RIB_TREE_AF_IPV6;
+	struct lyd_node *route_node = NULL;
+	char prefix_buffer[INET6_ADDRSTRLEN + 1 + 3] = {0};
+	char value_buffer[16] = {0};
+
+	// same for all routes of the list
+	rib_prefix_to_str(prefix, family, prefix_buffer, sizeof(prefix_buffer));
+
+	for (size_t i = 0; i < routes->size; i++) {
+		const struct route *ROUTE = &routes->list[i];
+
+		if (rib_tree_new_list(routes_node, schema->route, &route_node) != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new route node");
+			return -1;
+		}
+
+		// route-preference
+		snprintf(value_buffer, sizeof(value_buffer), "%u", ROUTE->preference);
+		if (rib_tree_new_term(route_node, schema->route_preference, value_buffer) != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new route-preference node");
+			return -1;
+		}
+
+		if (rib_tree_add_next_hop(schema, route_node, AF, &ROUTE->next_hop, names) != 0) {
+			return -1;
+		}
+
+		// destination-prefix
+		if (schema->destination_prefix[AF] != NULL && rib_tree_new_term(route_node, schema->destination_prefix[AF], prefix_buffer) != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new destination-prefix node");
+			return -1;
+		}
+
+		// route-metadata/source-protocol
+		if (rib_tree_new_term(route_node, schema->source_protocol, ROUTE->metadata.source_protocol) != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new source-protocol node");
+			return -1;
+		}
+
+		// route-metadata/active
+		if (ROUTE->metadata.active && rib_tree_new_term(route_node, schema->active, "") != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new active node");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static inline LY_ERR rib_tree_new_inner(struct lyd_node *parent, const struct lysc_node *schema, struct lyd_node **node)
+{
+	return lyd_new_inner(parent, schema->module, schema->name, false, node);
+}
+
+// route and next-hop lists are keyless - no key values are passed
+static inline LY_ERR rib_tree_new_list(struct lyd_node *parent, const struct lysc_node *schema, struct lyd_node **node)
+{
+	return lyd_new_list(parent, schema->module, schema->name, false, node);
+}
+
+static inline LY_ERR rib_tree_new_term(struct lyd_node *parent, const struct lysc_node *schema, const char *value)
+{
+	return lyd_new_term(parent, schema->module, schema->name, value, false, NULL);
+}
+
+static int rib_tree_add_next_hop(const struct rib_tree_schema *schema, struct lyd_node *route_node, size_t af, const struct route_next_hop *next_hop, const struct link_names *names)
+{
+	struct lyd_node *nh_node = NULL;
+	struct lyd_node *nh_list_node = NULL;
+	struct lyd_node *nh_entry_node = NULL;
+	char ip_buffer[INET6_ADDRSTRLEN + 4] = {0};
+	const char *if_name = NULL;
+
+	if (rib_tree_new_inner(route_node, schema->next_hop, &nh_node) != LY_SUCCESS) {
+		SRP_LOG_ERR("unable to create new next-hop node");
+		return -1;
+	}
+
+	switch (next_hop->kind) {
+		case route_next_hop_kind_none:
+			break;
+		case route_next_hop_kind_simple: {
+			const struct route_next_hop_simple *NEXTHOP = &next_hop->value.simple;
+
+			// link removed after the route was added - keep the last known name
+			if_name = link_names_get(names, NEXTHOP->ifindex);
+			if (if_name == NULL) {
+				if_name = NEXTHOP->if_name;
+			}
+
+			if (if_name != NULL && rib_tree_new_term(nh_node, schema->outgoing_interface, if_name) != LY_SUCCESS) {
+				SRP_LOG_ERR("unable to create new outgoing-interface node");
+				return -1;
+			}
+
+			if (NEXTHOP->addr != NULL && schema->next_hop_address[af] != NULL) {
+				nl_addr2str(NEXTHOP->addr, ip_buffer, sizeof(ip_buffer));
+				if (rib_tree_new_term(nh_node, schema->next_hop_address[af], ip_buffer) != LY_SUCCESS) {
+					SRP_LOG_ERR("unable to create new next-hop-address node");
+					return -1;
+				}
+			}
+			break;
+		}
+		case route_next_hop_kind_special:
+			if (next_hop->value.special.value != NULL && rib_tree_new_term(nh_node, schema->special_next_hop, next_hop->value.special.value) != LY_SUCCESS) {
+				SRP_LOG_ERR("unable to create new special-next-hop node");
+				return -1;
+			}
+			break;
+		case route_next_hop_kind_list: {
+			const struct route_next_hop_list *NEXTHOP_LIST = &next_hop->value.list;
+
+			if (rib_tree_new_inner(nh_node, schema->next_hop_list, &nh_list_node) != LY_SUCCESS) {
+				SRP_LOG_ERR("unable to create new next-hop-list node");
+				return -1;
+			}
+
+			for (size_t i = 0; i < NEXTHOP_LIST->size; i++) {
+				if (rib_tree_new_list(nh_list_node, schema->next_hop_list_next_hop, &nh_entry_node) != LY_SUCCESS) {
+					SRP_LOG_ERR("unable to create new next-hop-list/next-hop node");
+					return -1;
+				}
+
+				if_name = link_names_get(names, NEXTHOP_LIST->list[i].ifindex);
+				if (if_name == NULL) {
+					if_name = NEXTHOP_LIST->list[i].if_name;
+				}
+
+				if (if_name != NULL && rib_tree_new_term(nh_entry_node, schema->next_hop_list_outgoing_interface, if_name) != LY_SUCCESS) {
+					SRP_LOG_ERR("unable to create new outgoing-interface node");
+					return -1;
+				}
+
+				if (NEXTHOP_LIST->list[i].addr != NULL && schema->next_hop_list_address[af] != NULL) {
+					nl_addr2str(NEXTHOP_LIST->list[i].addr, ip_buffer, sizeof(ip_buffer));
+					if (rib_tree_new_term(nh_entry_node, schema->next_hop_list_address[af], ip_buffer) != LY_SUCCESS) {
+						SRP_LOG_ERR("unable to create new next-hop-list/next-hop/address node");
+						return -1;
+					}
+				}
+			}
+			break;
+		}
+	}
+
+	return 0;
+}
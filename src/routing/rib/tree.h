@@ -0,0 +1,40 @@
+#ifndef ROUTING_RIB_TREE_H
+#define ROUTING_RIB_TREE_H
+
+#include <netlink/addr.h>
+#include <libyang/libyang.h>
+
+#include "link_names.h"
+#include "route/list.h"
+
+// index of the address family specific (augmented) schema nodes
+#define ROUTING_RIB_TREE_AF_IPV4 0
+#define ROUTING_RIB_TREE_AF_IPV6 1
+#define ROUTING_RIB_TREE_AF_COUNT 2
+
+// schema nodes of a RIB route - resolved once per libyang context and used for creating
+// the data nodes directly instead of parsing a path for every node
+struct rib_tree_schema {
+	const struct ly_ctx *ly_ctx;
+
+	const struct lysc_node *route;
+	const struct lysc_node *route_preference;
+	const struct lysc_node *next_hop;
+	const struct lysc_node *outgoing_interface;
+	const struct lysc_node *special_next_hop;
+	const struct lysc_node *next_hop_list;
+	const struct lysc_node *next_hop_list_next_hop;
+	const struct lysc_node *next_hop_list_outgoing_interface;
+	const struct lysc_node *source_protocol;
+	const struct lysc_node *active;
+
+	// NULL if the address family module isn't implemented
+	const struct lysc_node *destination_prefix[ROUTING_RIB_TREE_AF_COUNT];
+	const struct lysc_node *next_hop_address[ROUTING_RIB_TREE_AF_COUNT];
+	const struct lysc_node *next_hop_list_address[ROUTING_RIB_TREE_AF_COUNT];
+};
+
+int rib_tree_schema_init(struct rib_tree_schema *schema, const struct ly_ctx *ly_ctx);
+int rib_tree_add_route_list(const struct rib_tree_schema *schema, struct lyd_node *routes_node, int family, struct nl_addr *prefix, const struct route_list *routes, const struct link_names *names);
+
+#endif // ROUTING_RIB_TREE_H
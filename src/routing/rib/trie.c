@@ -0,0 +1,217 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include "rib/trie.h"
+#include "utils/memory.h"
+
+static inline int rib_trie_bit(const uint8_t *key, unsigned int bit);
+static unsigned int rib_trie_common_len(const uint8_t *a, const uint8_t *b, unsigned int max_len);
+static unsigned int rib_trie_key(struct nl_addr *addr, uint8_t key[ROUTING_RIB_TRIE_KEY_SIZE]);
+static struct rib_trie_node *rib_trie_node_new(const uint8_t *key, unsigned int prefixlen, size_t position);
+static void rib_trie_collapse(struct rib_trie_node **link);
+static void rib_trie_node_free(struct rib_trie_node *node);
+
+void rib_trie_init(struct rib_trie *trie)
+{
+	trie->root = NULL;
+	trie->size = 0;
+}
+
+void rib_trie_insert(struct rib_trie *trie, struct nl_addr *prefix, size_t position)
+{
+	uint8_t key[ROUTING_RIB_TRIE_KEY_SIZE] = {0};
+	const unsigned int PREFIXLEN = rib_trie_key(prefix, key);
+	struct rib_trie_node **link = &trie->root;
+	struct rib_trie_node *node = NULL;
+	struct rib_trie_node *branch = NULL;
+	unsigned int common = 0;
+
+	while (*link != NULL) {
+		node = *link;
+		common = rib_trie_common_len(node->prefix, key, node->prefixlen < PREFIXLEN ? node->prefixlen : PREFIXLEN);
+
+		if (common == node->prefixlen) {
+			if (node->prefixlen == PREFIXLEN) {
+				// prefix already in the trie - update its position
+				if (node->position == 0) {
+					trie->size += 1;
+				}
+				node->position = position + 1;
+				return;
+			}
+			link = &node->child[rib_trie_bit(key, node->prefixlen)];
+			continue;
+		}
+
+		if (common == PREFIXLEN) {
+			// new prefix covers the current node - insert it above
+			branch = rib_trie_node_new(key, PREFIXLEN, position + 1);
+			branch->child[rib_trie_bit(node->prefix, PREFIXLEN)] = node;
+		} else {
+			// prefixes diverge at bit 'common' - add a branching node with both of them as children
+			branch = rib_trie_node_new(key, common, 0);
+			branch->child[rib_trie_bit(key, common)] = rib_trie_node_new(key, PREFIXLEN, position + 1);
+			branch->child[rib_trie_bit(node->prefix, common)] = node;
+		}
+		*link = branch;
+		trie->size += 1;
+		return;
+	}
+
+	*link = rib_trie_node_new(key, PREFIXLEN, position + 1);
+	trie->size += 1;
+}
+
+void rib_trie_remove(struct rib_trie *trie, struct nl_addr *prefix)
+{
+	uint8_t key[ROUTING_RIB_TRIE_KEY_SIZE] = {0};
+	const unsigned int PREFIXLEN = rib_trie_key(prefix, key);
+	struct rib_trie_node **link = &trie->root;
+	struct rib_trie_node **parent_link = NULL;
+	struct rib_trie_node *node = NULL;
+
+	while (*link != NULL) {
+		node = *link;
+		if (node->prefixlen > PREFIXLEN || rib_trie_common_len(node->prefix, key, node->prefixlen) != node->prefixlen) {
+			return;
+		}
+		if (node->prefixlen == PREFIXLEN) {
+			break;
+		}
+		parent_link = link;
+		link = &node->child[rib_trie_bit(key, node->prefixlen)];
+	}
+
+	if (*link == NULL || (*link)->position == 0) {
+		return;
+	}
+
+	(*link)->position = 0;
+	trie->size -= 1;
+
+	// keep the trie path-compressed - the removed node and its parent may now be redundant
+	rib_trie_collapse(link);
+	if (parent_link != NULL) {
+		rib_trie_collapse(parent_link);
+	}
+}
+
+int rib_trie_lookup(struct rib_trie *trie, struct nl_addr *addr, size_t *position)
+{
+	uint8_t key[ROUTING_RIB_TRIE_KEY_SIZE] = {0};
+	const unsigned int ADDRLEN = nl_addr_get_len(addr) * 8;
+	const struct rib_trie_node *node = trie->root;
+	size_t best = 0;
+
+	memcpy(key, nl_addr_get_binary_addr(addr), ADDRLEN / 8 < sizeof(key) ? ADDRLEN / 8 : sizeof(key));
+
+	// every visited node consumes at least one bit of the address - O(address length)
+	while (node != NULL && node->prefixlen <= ADDRLEN) {
+		if (rib_trie_common_len(node->prefix, key, node->prefixlen) != node->prefixlen) {
+			break;
+		}
+		if (node->position != 0) {
+			best = node->position;
+		}
+		if (node->prefixlen == ADDRLEN) {
+			break;
+		}
+		node = node->child[rib_trie_bit(key, node->prefixlen)];
+	}
+
+	if (best == 0) {
+		return -1;
+	}
+
+	*position = best - 1;
+	return 0;
+}
+
+void rib_trie_free(struct rib_trie *trie)
+{
+	rib_trie_node_free(trie->root);
+	rib_trie_init(trie);
+}
+
+static inline int rib_trie_bit(const uint8_t *key, unsigned int bit)
+{
+	return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+static unsigned int rib_trie_common_len(const uint8_t *a, const uint8_t *b, unsigned int max_len)
+{
+	unsigned int len = 0;
+
+	while (len + 8 <= max_len && a[len >> 3] == b[len >> 3]) {
+		len += 8;
+	}
+
+	while (len < max_len && rib_trie_bit(a, len) == rib_trie_bit(b, len)) {
+		len += 1;
+	}
+
+	return len;
+}
+
+// copies the prefix bytes into key, clears the host bits and returns the prefix length
+static unsigned int rib_trie_key(struct nl_addr *addr, uint8_t key[ROUTING_RIB_TRIE_KEY_SIZE])
+{
+	const unsigned int LEN = nl_addr_get_len(addr) < ROUTING_RIB_TRIE_KEY_SIZE ? nl_addr_get_len(addr) : ROUTING_RIB_TRIE_KEY_SIZE;
+	unsigned int prefixlen = nl_addr_get_prefixlen(addr);
+
+	if (prefixlen > LEN * 8) {
+		prefixlen = LEN * 8;
+	}
+
+	memcpy(key, nl_addr_get_binary_addr(addr), LEN);
+
+	if (prefixlen % 8) {
+		key[prefixlen / 8] &= (uint8_t) (0xff << (8 - prefixlen % 8));
+	}
+	for (unsigned int i = (prefixlen + 7) / 8; i < ROUTING_RIB_TRIE_KEY_SIZE; i++) {
+		key[i] = 0;
+	}
+
+	return prefixlen;
+}
+
+static struct rib_trie_node *rib_trie_node_new(const uint8_t *key, unsigned int prefixlen, size_t position)
+{
+	struct rib_trie_node *node = xcalloc(1, sizeof(struct rib_trie_node));
+
+	memcpy(node->prefix, key, sizeof(node->prefix));
+	node->prefixlen = (uint8_t) prefixlen;
+	node->position = position;
+
+	// branching nodes keep only the bits they cover
+	if (prefixlen % 8) {
+		node->prefix[prefixlen / 8] &= (uint8_t) (0xff << (8 - prefixlen % 8));
+	}
+	for (unsigned int i = (prefixlen + 7) / 8; i < ROUTING_RIB_TRIE_KEY_SIZE; i++) {
+		node->prefix[i] = 0;
+	}
+
+	return node;
+}
+
+// remove a node without a prefix which doesn't branch anymore
+static void rib_trie_collapse(struct rib_trie_node **link)
+{
+	struct rib_trie_node *node = *link;
+
+	if (node == NULL || node->position != 0 || (node->child[0] != NULL && node->child[1] != NULL)) {
+		return;
+	}
+
+	*link = node->child[0] != NULL ? node->child[0] : node->child[1];
+	FREE_SAFE(node);
+}
+
+static void rib_trie_node_free(struct rib_trie_node *node)
+{
+	if (node != NULL) {
+		rib_trie_node_free(node->child[0]);
+		rib_trie_node_free(node->child[1]);
+		FREE_SAFE(node);
+	}
+}
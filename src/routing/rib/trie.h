@@ -0,0 +1,32 @@
+#ifndef ROUTING_RIB_TRIE_H
+#define ROUTING_RIB_TRIE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <netlink/addr.h>
+
+// max address length in bytes - IPv6
+#define ROUTING_RIB_TRIE_KEY_SIZE 16
+
+// path-compressed binary trie node - branching nodes (position == 0) always have both children
+struct rib_trie_node {
+	uint8_t prefix[ROUTING_RIB_TRIE_KEY_SIZE];
+	uint8_t prefixlen;
+	// position + 1 of the prefix in the RIB route_list_hash, 0 for branching nodes
+	size_t position;
+	struct rib_trie_node *child[2];
+};
+
+// longest prefix match index of RIB destination prefixes
+struct rib_trie {
+	struct rib_trie_node *root;
+	size_t size;
+};
+
+void rib_trie_init(struct rib_trie *trie);
+void rib_trie_insert(struct rib_trie *trie, struct nl_addr *prefix, size_t position);
+void rib_trie_remove(struct rib_trie *trie, struct nl_addr *prefix);
+int rib_trie_lookup(struct rib_trie *trie, struct nl_addr *addr, size_t *position);
+void rib_trie_free(struct rib_trie *trie);
+
+#endif // ROUTING_RIB_TRIE_H
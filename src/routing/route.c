@@ -1,9 +1,17 @@
+#include <pthread.h>
+
 #include "route.h"
 #include "utils/memory.h"
 
+// source protocols are a handful of identities shared by every route - keep one copy of each
+static struct memory_intern route_strings;
+static pthread_mutex_t route_strings_lock = PTHREAD_MUTEX_INITIALIZER;
+
 void route_init(struct route *route)
 {
 	route->preference = 0;
+	route->tos = 0;
+	route->type = 0;
 	route->metadata.active = 0;
 	route->metadata.source_protocol = NULL;
 	route->metadata.last_updated = NULL;
@@ -16,22 +24,34 @@ void route_set_preference(struct route *route, uint32_t pref)
 	route->preference = pref;
 }
 
+void route_set_tos(struct route *route, uint8_t tos)
+{
+	route->tos = tos;
+}
+
+void route_set_type(struct route *route, uint8_t type)
+{
+	route->type = type;
+}
+
 void route_set_active(struct route *route, bool active)
 {
 	route->metadata.active = active;
 }
 
-void route_set_source_protocol(struct route *route, char *proto)
+void route_set_source_protocol(struct route *route, const char *proto)
 {
 	if (proto) {
-		route->metadata.source_protocol = xstrdup(proto);
+		pthread_mutex_lock(&route_strings_lock);
+		route->metadata.source_protocol = memory_intern_get(&route_strings, proto);
+		pthread_mutex_unlock(&route_strings_lock);
 	}
 }
 
 void route_set_last_updated(struct route *route, char *last_up)
 {
 	if (last_up) {
-		route->metadata.source_protocol = xstrdup(last_up);
+		route->metadata.last_updated = xstrdup(last_up);
 	}
 }
 
@@ -42,8 +62,10 @@ struct route route_clone(struct route *route)
 	route_init(&out);
 
 	route_set_preference(&out, route->preference);
+	route_set_tos(&out, route->tos);
+	route_set_type(&out, route->type);
 	route_set_active(&out, route->metadata.active);
-	route_set_source_protocol(&out, route->metadata.source_protocol);
+	out.metadata.source_protocol = route->metadata.source_protocol;
 	route_set_last_updated(&out, route->metadata.last_updated);
 	out.next_hop = route_next_hop_clone(&route->next_hop);
 
@@ -52,9 +74,6 @@ struct route route_clone(struct route *route)
 
 void route_free(struct route *route)
 {
-	if (route->metadata.source_protocol) {
-		FREE_SAFE(route->metadata.source_protocol);
-	}
 	if (route->metadata.last_updated) {
 		FREE_SAFE(route->metadata.last_updated);
 	}
@@ -66,3 +85,11 @@ void route_free(struct route *route)
 	route_next_hop_free(&route->next_hop);
 	route_init(route);
 }
+
+// releases the interned strings - no route may be used afterwards
+void route_strings_free(void)
+{
+	pthread_mutex_lock(&route_strings_lock);
+	memory_intern_free(&route_strings);
+	pthread_mutex_unlock(&route_strings_lock);
+}
@@ -8,7 +8,7 @@
 #include "route/next_hop.h"
 
 struct route_metadata {
-	char *source_protocol;
+	const char *source_protocol; // interned - shared by all routes, never freed per route
 	char *last_updated;
 	char *description; // used only in control_plane_protocol struct
 	bool active;
@@ -16,16 +16,22 @@ struct route_metadata {
 
 struct route {
 	uint32_t preference;
+	// together with the table and the preference identify the route in the kernel
+	uint8_t tos;
+	uint8_t type;
 	struct route_metadata metadata;
 	struct route_next_hop next_hop;
 };
 
 void route_init(struct route *route);
 void route_set_preference(struct route *route, uint32_t pref);
+void route_set_tos(struct route *route, uint8_t tos);
+void route_set_type(struct route *route, uint8_t type);
 void route_set_active(struct route *route, bool active);
-void route_set_source_protocol(struct route *route, char *proto);
+void route_set_source_protocol(struct route *route, const char *proto);
 void route_set_last_updated(struct route *route, char *last_up);
 struct route route_clone(struct route *route);
 void route_free(struct route *route);
+void route_strings_free(void);
 
 #endif // ROUTING_ROUTE_H
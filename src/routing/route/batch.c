@@ -0,0 +1,279 @@
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <netlink/msg.h>
+#include <netlink/netlink.h>
+
+#include <sysrepo.h>
+
+#include "route/batch.h"
+#include "utils/memory.h"
+
+// size of a single send - stays below the default socket send buffer
+#define ROUTE_BATCH_BUFFER_SIZE (32 * 1024)
+
+// requested receive buffer size - the kernel caps it to net.core.rmem_max
+#define ROUTE_BATCH_SOCKET_RECV_BUFFER_SIZE (4 * 1024 * 1024)
+
+// every ack is a separate skb in the receive buffer, accounted with its true size (around 1 kB) -
+// the number of unacked requests is bounded by the receive buffer so no ack gets dropped
+#define ROUTE_BATCH_ACK_TRUESIZE 2048
+#define ROUTE_BATCH_MIN_INFLIGHT 16
+#define ROUTE_BATCH_MAX_INFLIGHT 1024
+
+#define ROUTE_BATCH_RECV_BUFFER_SIZE (64 * 1024)
+
+#ifndef SOL_NETLINK
+#define SOL_NETLINK 270
+#endif
+
+#ifndef NETLINK_CAP_ACK
+#define NETLINK_CAP_ACK 10
+#endif
+
+static int route_batch_append(struct route_batch *batch, struct nl_msg *msg, int type, struct rtnl_route *route);
+static int route_batch_flush(struct route_batch *batch);
+static int route_batch_recv_acks(struct route_batch *batch, size_t max_inflight);
+
+int route_batch_init(struct route_batch *batch)
+{
+	int nl_err = 0;
+	const int ONE = 1;
+	int recv_buffer_size = 0;
+	socklen_t option_size = sizeof(recv_buffer_size);
+
+	memset(batch, 0, sizeof(*batch));
+
+	batch->socket = nl_socket_alloc();
+	if (batch->socket == NULL) {
+		SRP_LOG_ERR("unable to init nl_sock struct...");
+		goto error_out;
+	}
+
+	nl_err = nl_connect(batch->socket, NETLINK_ROUTE);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	// acks are matched by the sequence number only - no need for the kernel to echo the request back
+	if (setsockopt(nl_socket_get_fd(batch->socket), SOL_NETLINK, NETLINK_CAP_ACK, &ONE, sizeof(ONE)) != 0) {
+		SRP_LOG_DBG("NETLINK_CAP_ACK not supported: %s", strerror(errno));
+	}
+
+	nl_err = nl_socket_set_buffer_size(batch->socket, ROUTE_BATCH_SOCKET_RECV_BUFFER_SIZE, 0);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_socket_set_buffer_size failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	if (getsockopt(nl_socket_get_fd(batch->socket), SOL_SOCKET, SO_RCVBUF, &recv_buffer_size, &option_size) != 0) {
+		SRP_LOG_ERR("getsockopt failed: %s", strerror(errno));
+		goto error_out;
+	}
+
+	batch->max_inflight = (size_t) recv_buffer_size / ROUTE_BATCH_ACK_TRUESIZE;
+	if (batch->max_inflight < ROUTE_BATCH_MIN_INFLIGHT) {
+		batch->max_inflight = ROUTE_BATCH_MIN_INFLIGHT;
+	} else if (batch->max_inflight > ROUTE_BATCH_MAX_INFLIGHT) {
+		batch->max_inflight = ROUTE_BATCH_MAX_INFLIGHT;
+	}
+
+	batch->buffer = xmalloc(ROUTE_BATCH_BUFFER_SIZE);
+	batch->first_seq = nl_socket_use_seq(batch->socket);
+
+	return 0;
+
+error_out:
+	route_batch_free(batch);
+	return -1;
+}
+
+int route_batch_add(struct route_batch *batch, struct rtnl_route *route, int flags)
+{
+	struct nl_msg *msg = NULL;
+	int nl_err = 0;
+
+	nl_err = rtnl_route_build_add_request(route, flags, &msg);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("rtnl_route_build_add_request failed (%d): %s", nl_err, nl_geterror(nl_err));
+		return -1;
+	}
+
+	return route_batch_append(batch, msg, RTM_NEWROUTE, route);
+}
+
+int route_batch_delete(struct route_batch *batch, struct rtnl_route *route, int flags)
+{
+	struct nl_msg *msg = NULL;
+	int nl_err = 0;
+
+	nl_err = rtnl_route_build_del_request(route, flags, &msg);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("rtnl_route_build_del_request failed (%d): %s", nl_err, nl_geterror(nl_err));
+		return -1;
+	}
+
+	return route_batch_append(batch, msg, RTM_DELROUTE, route);
+}
+
+// send the remaining requests and wait for all acks - returns -1 if any of the batch requests failed
+int route_batch_commit(struct route_batch *batch)
+{
+	if (route_batch_flush(batch) != 0) {
+		return -1;
+	}
+
+	if (route_batch_recv_acks(batch, 0) != 0) {
+		return -1;
+	}
+
+	return batch->errors ? -1 : 0;
+}
+
+void route_batch_free(struct route_batch *batch)
+{
+	for (size_t i = 0; i < batch->requests_size; i++) {
+		if (batch->requests[i].dst) {
+			nl_addr_put(batch->requests[i].dst);
+		}
+	}
+
+	if (batch->requests) {
+		FREE_SAFE(batch->requests);
+	}
+
+	if (batch->buffer) {
+		FREE_SAFE(batch->buffer);
+	}
+
+	if (batch->socket) {
+		nl_socket_free(batch->socket);
+	}
+
+	memset(batch, 0, sizeof(*batch));
+}
+
+static int route_batch_append(struct route_batch *batch, struct nl_msg *msg, int type, struct rtnl_route *route)
+{
+	struct nlmsghdr *hdr = nlmsg_hdr(msg);
+	const size_t LEN = NLMSG_ALIGN(hdr->nlmsg_len);
+	struct nl_addr *dst = rtnl_route_get_dst(route);
+	int error = 0;
+
+	if (LEN > ROUTE_BATCH_BUFFER_SIZE) {
+		SRP_LOG_ERR("route request too large (%zu)", LEN);
+		error = -1;
+		goto out;
+	}
+
+	if (batch->buffer_size + LEN > ROUTE_BATCH_BUFFER_SIZE || batch->buffer_count == batch->max_inflight) {
+		error = route_batch_flush(batch);
+		if (error != 0) {
+			goto out;
+		}
+	}
+
+	if (batch->requests_size == batch->requests_capacity) {
+		batch->requests_capacity = batch->requests_capacity ? batch->requests_capacity * 2 : batch->max_inflight;
+		batch->requests = xrealloc(batch->requests, sizeof(struct route_batch_request) * batch->requests_capacity);
+	}
+
+	// sequence numbers are consecutive - the request position is derived from the ack sequence number
+	hdr->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+	hdr->nlmsg_seq = batch->first_seq + (uint32_t) batch->requests_size;
+	hdr->nlmsg_pid = nl_socket_get_local_port(batch->socket);
+
+	batch->requests[batch->requests_size].type = type;
+	batch->requests[batch->requests_size].dst = dst ? nl_addr_get(dst) : NULL;
+	batch->requests_size += 1;
+
+	memcpy(batch->buffer + batch->buffer_size, hdr, hdr->nlmsg_len);
+	memset(batch->buffer + batch->buffer_size + hdr->nlmsg_len, 0, LEN - hdr->nlmsg_len);
+	batch->buffer_size += LEN;
+	batch->buffer_count += 1;
+
+out:
+	nlmsg_free(msg);
+	return error;
+}
+
+// send all buffered messages with a single sendto() - the kernel processes them one after another
+static int route_batch_flush(struct route_batch *batch)
+{
+	int nl_err = 0;
+
+	if (batch->buffer_count == 0) {
+		return 0;
+	}
+
+	// make room for the acks of the buffered requests
+	if (route_batch_recv_acks(batch, batch->max_inflight - batch->buffer_count) != 0) {
+		return -1;
+	}
+
+	nl_err = nl_sendto(batch->socket, batch->buffer, batch->buffer_size);
+	if (nl_err < 0) {
+		SRP_LOG_ERR("nl_sendto failed (%d): %s", nl_err, nl_geterror(nl_err));
+		return -1;
+	}
+
+	batch->inflight += batch->buffer_count;
+	batch->buffer_size = 0;
+	batch->buffer_count = 0;
+
+	return 0;
+}
+
+// receive acks until at most max_inflight requests are left unacked
+static int route_batch_recv_acks(struct route_batch *batch, size_t max_inflight)
+{
+	char buffer[ROUTE_BATCH_RECV_BUFFER_SIZE];
+	char addr_buffer[INET6_ADDRSTRLEN + 4] = {0};
+	const int FD = nl_socket_get_fd(batch->socket);
+
+	while (batch->inflight > max_inflight) {
+		const ssize_t RECEIVED = recv(FD, buffer, sizeof(buffer), 0);
+		if (RECEIVED < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// ENOBUFS - acks were dropped, the outcome of the unacked requests is unknown
+			SRP_LOG_ERR("recv failed, %zu route requests left unacknowledged: %s", batch->inflight, strerror(errno));
+			batch->errors += batch->inflight;
+			batch->inflight = 0;
+			return -1;
+		}
+
+		int remaining = (int) RECEIVED;
+		for (struct nlmsghdr *hdr = (struct nlmsghdr *) buffer; nlmsg_ok(hdr, remaining); hdr = nlmsg_next(hdr, &remaining)) {
+			const size_t IDX = (size_t) (hdr->nlmsg_seq - batch->first_seq);
+			const struct nlmsgerr *ERR = NULL;
+
+			if (hdr->nlmsg_type != NLMSG_ERROR || IDX >= batch->requests_size) {
+				continue;
+			}
+
+			ERR = nlmsg_data(hdr);
+			batch->inflight -= 1;
+
+			if (ERR->error != 0) {
+				const struct route_batch_request *REQUEST = &batch->requests[IDX];
+
+				if (REQUEST->dst) {
+					nl_addr2str(REQUEST->dst, addr_buffer, sizeof(addr_buffer));
+				} else {
+					strcpy(addr_buffer, "none");
+				}
+
+				SRP_LOG_ERR("%s route %s failed (%d): %s", REQUEST->type == RTM_NEWROUTE ? "adding" : "deleting", addr_buffer, ERR->error, strerror(-ERR->error));
+				batch->errors += 1;
+			}
+		}
+	}
+
+	return 0;
+}
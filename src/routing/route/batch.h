@@ -0,0 +1,45 @@
+#ifndef ROUTING_ROUTE_BATCH_H
+#define ROUTING_ROUTE_BATCH_H
+
+#include <stdint.h>
+#include <netlink/addr.h>
+#include <netlink/socket.h>
+#include <netlink/route/route.h>
+
+// request sent in a batch - acks are matched to requests by the sequence number
+struct route_batch_request {
+	int type; // RTM_NEWROUTE or RTM_DELROUTE
+	struct nl_addr *dst;
+};
+
+// struct collects RTM_NEWROUTE/RTM_DELROUTE messages into a single send buffer,
+// sends the buffer once it fills up and collects the acks of the sent requests
+struct route_batch {
+	struct nl_sock *socket;
+
+	// serialized messages not sent yet
+	char *buffer;
+	size_t buffer_size;
+	size_t buffer_count;
+
+	// all requests of the batch - request of sequence number seq is at requests[seq - first_seq]
+	struct route_batch_request *requests;
+	size_t requests_size;
+	size_t requests_capacity;
+	uint32_t first_seq;
+
+	// sent requests waiting for an ack - bounded by the socket receive buffer size
+	size_t inflight;
+	size_t max_inflight;
+
+	// number of requests rejected by the kernel
+	size_t errors;
+};
+
+int route_batch_init(struct route_batch *batch);
+int route_batch_add(struct route_batch *batch, struct rtnl_route *route, int flags);
+int route_batch_delete(struct route_batch *batch, struct rtnl_route *route, int flags);
+int route_batch_commit(struct route_batch *batch);
+void route_batch_free(struct route_batch *batch);
+
+#endif // ROUTING_ROUTE_BATCH_H
@@ -8,7 +8,9 @@ void route_list_init(struct route_list *ls)
 {
 	ls->list = NULL;
 	ls->size = 0;
+	ls->capacity = 0;
 	ls->delete = false;
+	ls->dirty = false;
 }
 
 bool route_list_is_empty(struct route_list *ls)
@@ -16,11 +18,24 @@ bool route_list_is_empty(struct route_list *ls)
 	return ls->list == NULL && ls->size == 0;
 }
 
+void route_list_reserve(struct route_list *ls, size_t capacity)
+{
+	if (capacity > ls->capacity) {
+		ls->list = xrealloc(ls->list, sizeof(struct route) * capacity);
+		ls->capacity = capacity;
+	}
+}
+
+// moves the route into the list - route is left empty (initialized) and still safe to pass to route_free()
 void route_list_add(struct route_list *ls, struct route *route)
 {
-	ls->list = xrealloc(ls->list, sizeof(struct route) * (unsigned long) (ls->size + 1));
-	ls->list[ls->size] = route_clone(route);
+	// most prefixes have a single route - start with one slot and double from there
+	if (ls->size == ls->capacity) {
+		route_list_reserve(ls, ls->capacity ? ls->capacity * 2 : 1);
+	}
+	ls->list[ls->size] = *route;
 	ls->size += 1;
+	route_init(route);
 }
 
 struct route *route_list_get_last(struct route_list *ls)
@@ -28,6 +43,40 @@ struct route *route_list_get_last(struct route_list *ls)
 	return &ls->list[ls->size - 1];
 }
 
+void route_list_remove(struct route_list *ls, size_t idx)
+{
+	route_free(&ls->list[idx]);
+
+	// order of the routes isn't important - move the last one into the freed place
+	if (idx != ls->size - 1) {
+		ls->list[idx] = ls->list[ls->size - 1];
+	}
+	ls->size -= 1;
+
+	if (ls->size == 0) {
+		FREE_SAFE(ls->list);
+		ls->capacity = 0;
+	}
+}
+
+// mark the route with the lowest preference value as the active one
+void route_list_update_active(struct route_list *ls)
+{
+	struct route *pref = NULL;
+
+	for (size_t i = 0; i < ls->size; i++) {
+		struct route *ptr = &ls->list[i];
+		route_set_active(ptr, false);
+		if (pref == NULL || ptr->preference < pref->preference) {
+			pref = ptr;
+		}
+	}
+
+	if (pref != NULL) {
+		route_set_active(pref, true);
+	}
+}
+
 void route_list_free(struct route_list *ls)
 {
 	if (ls->list) {
@@ -6,13 +6,18 @@
 struct route_list {
 	struct route *list;
 	bool delete;
+	bool dirty; // prefix changed in the current change transaction
 	size_t size;
+	size_t capacity;
 };
 
 void route_list_init(struct route_list *ls);
 bool route_list_is_empty(struct route_list *ls);
+void route_list_reserve(struct route_list *ls, size_t capacity);
 void route_list_add(struct route_list *ls, struct route *route);
 struct route *route_list_get_last(struct route_list *ls);
+void route_list_remove(struct route_list *ls, size_t idx);
+void route_list_update_active(struct route_list *ls);
 void route_list_free(struct route_list *ls);
 
 #endif // ROUTING_ROUTE_LIST_H
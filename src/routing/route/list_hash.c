@@ -1,70 +1,270 @@
-#include <sysrepo.h>
+#include <string.h>
+#include <netlink/addr.h>
 
 #include "route/list_hash.h"
 #include "utils/memory.h"
 
+#define ROUTE_LIST_HASH_INITIAL_CAPACITY 16
+
+static uint32_t route_list_hash_key(struct nl_addr *addr);
+static size_t route_list_hash_find_slot(struct route_list_hash *hash, struct nl_addr *addr, uint32_t key);
+static void route_list_hash_index_insert(struct route_list_hash *hash, uint32_t key, size_t position);
+static void route_list_hash_index_remove(struct route_list_hash *hash, size_t slot);
+static void route_list_hash_index_resize(struct route_list_hash *hash, size_t index_size);
+static void route_list_hash_reserve(struct route_list_hash *hash, size_t capacity);
+
 void route_list_hash_init(struct route_list_hash *hash)
 {
 	hash->list_addr = NULL;
 	hash->list_route = NULL;
 	hash->size = 0;
+	hash->capacity = 0;
+	hash->index = NULL;
+	hash->index_size = 0;
+	hash->free_list = NULL;
+	hash->free_count = 0;
+	hash->dirty_list = NULL;
+	hash->dirty_count = 0;
 }
 
 void route_list_hash_add(struct route_list_hash *hash, struct nl_addr *addr, struct route *route)
 {
-	struct route_list *exists = NULL;
+	const uint32_t KEY = route_list_hash_key(addr);
+	size_t slot = 0;
+	size_t position = 0;
 
-	exists = route_list_hash_get_by_addr(hash, addr);
-	if (exists != NULL) {
-		route_list_add(exists, route);
-	} else {
-		for (size_t i = 0; i < hash->size; i++) {
-			if (route_list_is_empty(&hash->list_route[i]) && hash->list_addr[i] == NULL) {
-				hash->list_addr[i] = nl_addr_clone(addr);
-				route_list_add(&hash->list_route[i], route);
-				return;
-			}
+	if (hash->index_size) {
+		slot = route_list_hash_find_slot(hash, addr, KEY);
+		if (hash->index[slot].position != 0) {
+			route_list_add(&hash->list_route[hash->index[slot].position - 1], route);
+			return;
 		}
+	}
 
-		hash->list_addr = xrealloc(hash->list_addr, sizeof(struct nl_addr *) * (unsigned long) (hash->size + 1));
-		hash->list_route = xrealloc(hash->list_route, sizeof(struct route_list) * (unsigned long) (hash->size + 1));
-		hash->list_addr[hash->size] = nl_addr_clone(addr);
-		route_list_init(&hash->list_route[hash->size]);
-		route_list_add(&hash->list_route[hash->size], route);
+	if (hash->free_count > 0) {
+		// reuse a position freed by route_list_hash_prune()
+		position = hash->free_list[--hash->free_count];
+		route_list_init(&hash->list_route[position]);
+	} else {
+		if (hash->size == hash->capacity) {
+			route_list_hash_reserve(hash, hash->capacity ? hash->capacity * 2 : ROUTE_LIST_HASH_INITIAL_CAPACITY);
+		}
+		position = hash->size;
+		route_list_init(&hash->list_route[position]);
 		hash->size += 1;
 	}
+
+	hash->list_addr[position] = nl_addr_clone(addr);
+	route_list_add(&hash->list_route[position], route);
+
+	route_list_hash_index_insert(hash, KEY, position);
 }
 
 void route_list_hash_free(struct route_list_hash *hash)
 {
 	if (hash->size) {
 		for (size_t i = 0; i < hash->size; i++) {
-			nl_addr_put(hash->list_addr[i]);
+			if (hash->list_addr[i] != NULL) {
+				nl_addr_put(hash->list_addr[i]);
+			}
 			route_list_free(&hash->list_route[i]);
 		}
+	}
+
+	if (hash->capacity) {
 		FREE_SAFE(hash->list_addr);
 		FREE_SAFE(hash->list_route);
+		FREE_SAFE(hash->free_list);
+		FREE_SAFE(hash->dirty_list);
+	}
+
+	if (hash->index) {
+		FREE_SAFE(hash->index);
 	}
+
 	route_list_hash_init(hash);
 }
 
 struct route_list *route_list_hash_get_by_addr(struct route_list_hash *hash, struct nl_addr *addr)
 {
-	for (size_t i = 0; i < hash->size; i++) {
-		if (hash->list_addr[i] != NULL && nl_addr_cmp(addr, hash->list_addr[i]) == 0) {
-			return &hash->list_route[i];
-		}
+	size_t slot = 0;
+
+	if (hash->index_size == 0) {
+		return NULL;
+	}
+
+	slot = route_list_hash_find_slot(hash, addr, route_list_hash_key(addr));
+	if (hash->index[slot].position == 0) {
+		return NULL;
 	}
-	return NULL;
+
+	return &hash->list_route[hash->index[slot].position - 1];
 }
 
+// add the prefix to the dirty set - no-op for an unknown prefix or an already dirty one
+void route_list_hash_mark_dirty(struct route_list_hash *hash, struct nl_addr *addr)
+{
+	struct route_list *ls = route_list_hash_get_by_addr(hash, addr);
+
+	if (ls == NULL || ls->dirty) {
+		return;
+	}
+
+	ls->dirty = true;
+	hash->dirty_list[hash->dirty_count++] = (size_t) (ls - hash->list_route);
+}
+
+// remove the prefixes marked for deletion and clear the dirty set
+// prefixes are only marked for deletion together with being marked dirty - only the dirty set is visited
 void route_list_hash_prune(struct route_list_hash *hash)
 {
-	for (size_t i = 0; i < hash->size; i++) {
-		if (hash->list_route[i].delete) {
-			route_list_free(&hash->list_route[i]);
-			nl_addr_put(hash->list_addr[i]);
-			hash->list_addr[i] = NULL;
+	for (size_t i = 0; i < hash->dirty_count; i++) {
+		const size_t POSITION = hash->dirty_list[i];
+		struct route_list *ls = &hash->list_route[POSITION];
+
+		ls->dirty = false;
+		if (ls->delete && hash->list_addr[POSITION] != NULL) {
+			route_list_hash_remove(hash, hash->list_addr[POSITION]);
 		}
 	}
+
+	hash->dirty_count = 0;
+}
+
+void route_list_hash_remove(struct route_list_hash *hash, struct nl_addr *addr)
+{
+	size_t slot = 0;
+	size_t position = 0;
+
+	if (hash->index_size == 0) {
+		return;
+	}
+
+	slot = route_list_hash_find_slot(hash, addr, route_list_hash_key(addr));
+	if (hash->index[slot].position == 0) {
+		return;
+	}
+
+	position = hash->index[slot].position - 1;
+
+	route_list_hash_index_remove(hash, slot);
+	route_list_free(&hash->list_route[position]);
+	nl_addr_put(hash->list_addr[position]);
+	hash->list_addr[position] = NULL;
+	hash->free_list[hash->free_count++] = position;
+}
+
+// FNV-1a over the family, prefix length and prefix bytes - the same fields nl_addr_cmp() compares
+static uint32_t route_list_hash_key(struct nl_addr *addr)
+{
+	const unsigned char *bytes = nl_addr_get_binary_addr(addr);
+	const unsigned int LEN = nl_addr_get_len(addr);
+	uint32_t key = 2166136261u;
+
+	key = (key ^ (uint32_t) nl_addr_get_family(addr)) * 16777619u;
+	key = (key ^ (uint32_t) nl_addr_get_prefixlen(addr)) * 16777619u;
+	key = (key ^ (uint32_t) LEN) * 16777619u;
+
+	for (unsigned int i = 0; i < LEN; i++) {
+		key = (key ^ bytes[i]) * 16777619u;
+	}
+
+	return key;
+}
+
+// returns the slot holding addr or the empty slot where addr would be inserted
+static size_t route_list_hash_find_slot(struct route_list_hash *hash, struct nl_addr *addr, uint32_t key)
+{
+	const size_t MASK = hash->index_size - 1;
+	size_t slot = key & MASK;
+
+	while (hash->index[slot].position != 0) {
+		const struct route_list_hash_slot *ptr = &hash->index[slot];
+		if (ptr->hash == key && nl_addr_cmp(addr, hash->list_addr[ptr->position - 1]) == 0) {
+			break;
+		}
+		slot = (slot + 1) & MASK;
+	}
+
+	return slot;
+}
+
+static void route_list_hash_index_insert(struct route_list_hash *hash, uint32_t key, size_t position)
+{
+	size_t mask = 0;
+	size_t slot = 0;
+
+	// keep the load factor at or below 1/2 - live entries are size - free_count
+	if ((hash->size - hash->free_count) * 2 > hash->index_size) {
+		route_list_hash_index_resize(hash, hash->index_size ? hash->index_size * 2 : ROUTE_LIST_HASH_INITIAL_CAPACITY * 2);
+	}
+
+	mask = hash->index_size - 1;
+	slot = key & mask;
+	while (hash->index[slot].position != 0) {
+		slot = (slot + 1) & mask;
+	}
+
+	hash->index[slot].hash = key;
+	hash->index[slot].position = (uint32_t) position + 1;
+}
+
+// backward shift deletion - no tombstones are left in the index
+static void route_list_hash_index_remove(struct route_list_hash *hash, size_t slot)
+{
+	const size_t MASK = hash->index_size - 1;
+	size_t hole = slot;
+	size_t next = slot;
+
+	hash->index[hole].position = 0;
+
+	while (true) {
+		next = (next + 1) & MASK;
+		if (hash->index[next].position == 0) {
+			break;
+		}
+
+		const size_t HOME = hash->index[next].hash & MASK;
+
+		// entry can stay if its home slot lies cyclically in (hole, next]
+		if ((hole <= next) ? (hole < HOME && HOME <= next) : (hole < HOME || HOME <= next)) {
+			continue;
+		}
+
+		hash->index[hole] = hash->index[next];
+		hash->index[next].position = 0;
+		hole = next;
+	}
+}
+
+static void route_list_hash_index_resize(struct route_list_hash *hash, size_t index_size)
+{
+	struct route_list_hash_slot *old_index = hash->index;
+	const size_t OLD_SIZE = hash->index_size;
+
+	hash->index = xcalloc(index_size, sizeof(struct route_list_hash_slot));
+	hash->index_size = index_size;
+
+	for (size_t i = 0; i < OLD_SIZE; i++) {
+		if (old_index[i].position != 0) {
+			size_t slot = old_index[i].hash & (index_size - 1);
+			while (hash->index[slot].position != 0) {
+				slot = (slot + 1) & (index_size - 1);
+			}
+			hash->index[slot] = old_index[i];
+		}
+	}
+
+	if (old_index) {
+		FREE_SAFE(old_index);
+	}
+}
+
+static void route_list_hash_reserve(struct route_list_hash *hash, size_t capacity)
+{
+	hash->list_addr = xrealloc(hash->list_addr, sizeof(struct nl_addr *) * capacity);
+	hash->list_route = xrealloc(hash->list_route, sizeof(struct route_list) * capacity);
+	hash->free_list = xrealloc(hash->free_list, sizeof(size_t) * capacity);
+	hash->dirty_list = xrealloc(hash->dirty_list, sizeof(size_t) * capacity);
+	hash->capacity = capacity;
 }
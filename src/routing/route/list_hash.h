@@ -1,23 +1,47 @@
 #ifndef ROUTING_ROUTE_LIST_HASH_H
 #define ROUTING_ROUTE_LIST_HASH_H
 
+#include <stdint.h>
 #include <netlink/addr.h>
 
 #include "route.h"
 #include "route/list.h"
 
-// "hash" like struct - simpler implementation rather than adding one more linked list struct for real hash implementation
+// index slot - position + 1 of the prefix in list_addr/list_route, 0 marks an empty slot
+struct route_list_hash_slot {
+	uint32_t hash;
+	uint32_t position;
+};
+
 // struct maps lists of routes by the destionation prefix
+// prefixes and their routes are stored in two parallel arrays (iterated by the users of the struct)
+// and looked up using an open addressing (linear probing) index keyed by family, prefix bytes and prefix length
 struct route_list_hash {
 	struct nl_addr **list_addr;
 	struct route_list *list_route;
 	size_t size;
+	size_t capacity;
+
+	// open addressing index - power of two size, kept at most half full
+	struct route_list_hash_slot *index;
+	size_t index_size;
+
+	// positions in the parallel arrays freed by pruning and reused by the next add
+	size_t *free_list;
+	size_t free_count;
+
+	// positions of the prefixes marked dirty since the last prune
+	size_t *dirty_list;
+	size_t dirty_count;
 };
 
 void route_list_hash_init(struct route_list_hash *hash);
+// takes ownership of the route contents (see route_list_add())
 void route_list_hash_add(struct route_list_hash *hash, struct nl_addr *addr, struct route *route);
 void route_list_hash_free(struct route_list_hash *hash);
+void route_list_hash_mark_dirty(struct route_list_hash *hash, struct nl_addr *addr);
 void route_list_hash_prune(struct route_list_hash *hash);
+void route_list_hash_remove(struct route_list_hash *hash, struct nl_addr *addr);
 struct route_list *route_list_hash_get_by_addr(struct route_list_hash *hash, struct nl_addr *addr);
 
 #endif // ROUTING_ROUTE_LIST_HASH_H
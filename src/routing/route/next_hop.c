@@ -13,7 +13,7 @@ void route_next_hop_set_simple(struct route_next_hop *nh, int ifindex, const cha
 {
 	nh->kind = route_next_hop_kind_simple;
 	nh->value.simple.ifindex = ifindex;
-	nh->value.simple.if_name = xstrdup(if_name);
+	nh->value.simple.if_name = if_name ? xstrdup(if_name) : NULL;
 	if (gw) {
 		nh->value.simple.addr = nl_addr_clone(gw);
 	} else {
@@ -29,25 +29,39 @@ void route_next_hop_set_special(struct route_next_hop *nh, char *value)
 	}
 }
 
-void route_next_hop_add_list(struct route_next_hop *nh, int ifindex, const char *if_name, struct nl_addr *gw)
+// turns an empty next hop into a list with room for capacity entries
+void route_next_hop_reserve_list(struct route_next_hop *nh, size_t capacity)
 {
-	int idx = 0;
+	struct route_next_hop_list *ls = &nh->value.list;
 
 	if (nh->kind == route_next_hop_kind_none) {
-		// initialize the list
 		nh->kind = route_next_hop_kind_list;
-		nh->value.list.list = xmalloc(sizeof(struct route_next_hop_simple));
-		idx = 0;
-	} else {
-		nh->value.list.list = xrealloc(nh->value.list.list, sizeof(struct route_next_hop_simple) * (unsigned long) (nh->value.list.size + 1));
-		idx = nh->value.list.size;
+		ls->list = NULL;
+		ls->size = 0;
+		ls->capacity = 0;
+	}
+
+	if (capacity > ls->capacity) {
+		ls->list = xrealloc(ls->list, sizeof(struct route_next_hop_simple) * capacity);
+		ls->capacity = capacity;
 	}
-	nh->value.list.list[idx].ifindex = ifindex;
-	nh->value.list.list[idx].if_name = xstrdup(if_name);
+}
+
+void route_next_hop_add_list(struct route_next_hop *nh, int ifindex, const char *if_name, struct nl_addr *gw)
+{
+	struct route_next_hop_simple *hop = NULL;
+
+	if (nh->kind == route_next_hop_kind_none || nh->value.list.size == nh->value.list.capacity) {
+		route_next_hop_reserve_list(nh, nh->kind == route_next_hop_kind_list && nh->value.list.capacity ? nh->value.list.capacity * 2 : 2);
+	}
+
+	hop = &nh->value.list.list[nh->value.list.size];
+	hop->ifindex = ifindex;
+	hop->if_name = if_name ? xstrdup(if_name) : NULL;
 	if (gw) {
-		nh->value.list.list[idx].addr = nl_addr_clone(gw);
+		hop->addr = nl_addr_clone(gw);
 	} else {
-		nh->value.list.list[idx].addr = NULL;
+		hop->addr = NULL;
 	}
 	++nh->value.list.size;
 }
@@ -66,7 +80,8 @@ struct route_next_hop route_next_hop_clone(struct route_next_hop *nh)
 			route_next_hop_set_special(&out, nh->value.special.value);
 			break;
 		case route_next_hop_kind_list:
-			for (int i = 0; i < nh->value.list.size; i++) {
+			route_next_hop_reserve_list(&out, nh->value.list.size);
+			for (size_t i = 0; i < nh->value.list.size; i++) {
 				route_next_hop_add_list(&out, nh->value.list.list[i].ifindex, nh->value.list.list[i].if_name, nh->value.list.list[i].addr);
 			}
 			break;
@@ -96,14 +111,14 @@ void route_next_hop_free(struct route_next_hop *nh)
 			}
 			break;
 		case route_next_hop_kind_list:
-			if (nh->value.list.size > 0) {
-				for (int i = 0; i < nh->value.list.size; i++) {
+			if (nh->value.list.capacity > 0) {
+				for (size_t i = 0; i < nh->value.list.size; i++) {
 					if (nh->value.list.list[i].addr) {
 						nl_addr_put(nh->value.list.list[i].addr);
 					}
 
-					if (nh->value.simple.if_name) {
-						FREE_SAFE(nh->value.simple.if_name);
+					if (nh->value.list.list[i].if_name) {
+						FREE_SAFE(nh->value.list.list[i].if_name);
 					}
 				}
 				FREE_SAFE(nh->value.list.list);
@@ -24,6 +24,7 @@ struct route_next_hop_special {
 struct route_next_hop_list {
 	struct route_next_hop_simple *list;
 	size_t size;
+	size_t capacity;
 };
 
 union route_next_hop_value {
@@ -40,6 +41,7 @@ struct route_next_hop {
 void route_next_hop_init(struct route_next_hop *nh);
 void route_next_hop_set_simple(struct route_next_hop *nh, int ifindex, const char *if_name, struct nl_addr *gw);
 void route_next_hop_set_special(struct route_next_hop *nh, char *value);
+void route_next_hop_reserve_list(struct route_next_hop *nh, size_t capacity);
 void route_next_hop_add_list(struct route_next_hop *nh, int ifindex, const char *if_name, struct nl_addr *gw);
 struct route_next_hop route_next_hop_clone(struct route_next_hop *nh);
 void route_next_hop_free(struct route_next_hop *nh);
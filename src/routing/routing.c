@@ -1,7 +1,10 @@
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <linux/genetlink.h>
 #include <linux/limits.h>
@@ -11,6 +14,7 @@
 #include <sys/socket.h>
 #include <netlink/addr.h>
 #include <netlink/cache.h>
+#include <netlink/msg.h>
 #include <netlink/socket.h>
 #include <netlink/route/link.h>
 #include <netlink/route/route.h>
@@ -20,9 +24,12 @@
 #include <sysrepo/xpath.h>
 
 #include "routing.h"
+#include "link_names.h"
 #include "rib.h"
 #include "rib/list.h"
 #include "rib/description_pair.h"
+#include "rib/tree.h"
+#include "route/batch.h"
 #include "route/list.h"
 #include "route/list_hash.h"
 #include "control_plane_protocol.h"
@@ -62,6 +69,14 @@
 // sysrepocfg
 #define SYSREPOCFG_EMPTY_CHECK_COMMAND "sysrepocfg -X -d running -m " BASE_YANG_MODEL
 
+#ifndef SOL_NETLINK
+#define SOL_NETLINK 270
+#endif
+
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK 12
+#endif
+
 // module change
 static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *xpath, sr_event_t event, uint32_t request_id, void *private_data);
 
@@ -78,6 +93,7 @@ static int delete_rib_value(char *node_xpath);
 
 // getting xpath from the node
 static char *routing_xpath_get(const struct lyd_node *node);
+static char *routing_xpath_predicate_get(const char *xpath, const char *node_name, const char *key_name);
 
 // control-plane-protocol list module changes
 static int routing_control_plane_protocol_set_description(const char *type, const char *name, const char *description);
@@ -87,23 +103,50 @@ static int routing_rib_set_address_family(const char *name, const char *address_
 static int routing_rib_set_description(const char *name, const char *description);
 
 // operational callbacks
+static int routing_oper_get_ribs_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
 static int routing_oper_get_rib_routes_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
 static int routing_oper_get_interfaces_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
 
 // rpc callbacks
 static int routing_rpc_active_route_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *xpath, const sr_val_t *input, const size_t input_cnt, sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt, void *private_data);
+static int routing_rpc_active_route_set_value(sr_val_t *value, const char *xpath, const char *node, sr_type_t type, const char *data);
 
 // initial loading into the datastore
 static int routing_load_data(sr_session_ctx_t *session);
 static int routing_load_ribs(sr_session_ctx_t *session, struct lyd_node *routing_container_node);
 static int routing_collect_ribs(struct nl_cache *routes_cache, struct rib_list *ribs);
-static int routing_collect_routes(struct nl_cache *routes_cache, struct nl_cache *link_cache, struct rib_list *ribs);
+static int routing_collect_routes(struct nl_cache *routes_cache, struct rib_list *ribs);
 static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struct lyd_node *routing_container_node);
 static int routing_build_rib_descriptions(struct rib_list *ribs);
 static inline int routing_is_rib_known(int table);
 static int routing_build_protos_map(struct control_plane_protocol map[ROUTING_PROTOS_COUNT]);
 static inline int routing_is_proto_type_known(int type);
 static bool routing_running_datastore_is_empty(void);
+static struct route_list *routing_rib_get_prefix(struct rib *rib, const char *prefix);
+
+// persistent RIBs - loaded once and kept up to date with the kernel routes by the cache manager
+static struct rib_list routing_ribs = {0};
+static pthread_mutex_t routing_ribs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// cache manager for routes and links - caches and routing_ribs are changed only by its thread while holding routing_ribs_lock
+static struct nl_cache_mngr *routing_cache_manager = NULL;
+static struct nl_cache *routing_route_cache = NULL;
+static struct nl_cache *routing_link_cache = NULL;
+
+// ifindex -> name of all links, updated by link events - used for resolving next-hop interfaces
+static struct link_names routing_link_names = {0};
+
+// schema nodes used by the RIB oper callback - guarded by routing_ribs_lock as well
+static struct rib_tree_schema routing_rib_schema = {0};
+static pthread_t routing_cache_manager_thread;
+static volatile int routing_cache_manager_exit = 0;
+
+static int routing_rib_cache_init(void);
+static void routing_rib_cache_free(void);
+static void *routing_cache_manager_thread_cb(void *data);
+static void routing_route_change_cb(struct nl_cache *cache, struct nl_object *obj, int action, void *arg);
+static void routing_link_change_cb(struct nl_cache *cache, struct nl_object *obj, int action, void *arg);
+static void routing_build_route(struct rtnl_route *route, struct route *out);
 
 static struct route_list_hash *ipv4_static_routes = NULL;
 static struct route_list_hash *ipv6_static_routes = NULL;
@@ -111,6 +154,12 @@ static struct route_list_hash *ipv6_static_routes = NULL;
 static int static_routes_init(struct route_list_hash **ipv4_routes, struct route_list_hash **ipv6_routes);
 static void foreach_nexthop(struct rtnl_nexthop *nh, void *arg);
 static int update_static_routes(struct route_list_hash *routes, uint8_t family);
+static int static_routes_delete_stale(struct route_batch *batch, struct route_list_hash *installed, struct nl_addr *dst, uint32_t preference, uint8_t family);
+static void static_routes_rollback(struct route_list_hash *routes, uint8_t family);
+static int static_routes_load_installed(uint8_t family, struct route_list_hash *installed);
+static int static_routes_installed_cb(struct nl_msg *msg, void *arg);
+static bool static_route_is_installed(struct route_list_hash *installed, struct nl_addr *dst, const struct route *route, bool compare_next_hop);
+static bool static_route_next_hop_matches(const struct route_next_hop *config, const struct route_next_hop *installed);
 
 int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 {
@@ -131,6 +180,12 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 
 	*private_data = startup_session;
 
+	error = routing_rib_cache_init();
+	if (error) {
+		SRP_LOG_ERR("routing_rib_cache_init error");
+		goto error_out;
+	}
+
 	error = static_routes_init(&ipv4_static_routes, &ipv6_static_routes);
 	if (error) {
 		SRP_LOG_ERR("static_routes_init error");
@@ -169,8 +224,14 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 		goto error_out;
 	}
 
-	// RIB oper data
-	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, ROUTING_RIB_LIST_YANG_PATH, routing_oper_get_rib_routes_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	// RIB oper data - the routes provider is called for each RIB entry and only if the request selects the routes
+	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, ROUTING_RIB_LIST_YANG_PATH, routing_oper_get_ribs_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
+	if (error) {
+		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
+		goto error_out;
+	}
+
+	error = sr_oper_get_items_subscribe(session, BASE_YANG_MODEL, ROUTING_RIB_LIST_YANG_PATH "/routes", routing_oper_get_rib_routes_cb, NULL, SR_SUBSCR_CTX_REUSE, &subscription);
 	if (error) {
 		SRP_LOG_ERR("sr_oper_get_items_subscribe error (%d): %s", error, sr_strerror(error));
 		goto error_out;
@@ -194,17 +255,8 @@ out:
 
 static int static_routes_init(struct route_list_hash **ipv4_routes, struct route_list_hash **ipv6_routes)
 {
-	int nl_err = 0;
-	int error = 0;
-
-	struct nl_sock *socket = NULL;
 	struct rtnl_route *route = NULL;
-	struct nl_cache *cache = NULL;
-	struct nl_cache *link_cache = NULL;
 	struct route tmp_route = {0};
-	struct rtnl_link *iface = NULL;
-	char *if_name = NULL;
-	int ifindex = 0;
 
 	*ipv4_routes = xmalloc(sizeof(struct route_list_hash));
 	*ipv6_routes = xmalloc(sizeof(struct route_list_hash));
@@ -212,55 +264,16 @@ static int static_routes_init(struct route_list_hash **ipv4_routes, struct route
 	route_list_hash_init(*ipv4_routes);
 	route_list_hash_init(*ipv6_routes);
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("unable to init nl_sock struct...");
-		goto error_out;
-	}
+	// routes and link names are already cached by routing_rib_cache_init()
+	pthread_mutex_lock(&routing_ribs_lock);
 
-	nl_err = nl_connect(socket, NETLINK_ROUTE);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	nl_err = rtnl_route_alloc_cache(socket, AF_UNSPEC, 0, &cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	nl_err = rtnl_link_alloc_cache(socket, AF_UNSPEC, &link_cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	route = (struct rtnl_route *) nl_cache_get_first(cache);
+	route = (struct rtnl_route *) nl_cache_get_first(routing_route_cache);
 	while (route != NULL) {
 		const int PROTO = rtnl_route_get_protocol(route);
 
 		if (PROTO == RTPROT_STATIC) {
 			const int AF = rtnl_route_get_family(route);
-			// fill the route with info and add to the hash of the current RIB
-			route_init(&tmp_route);
-			route_set_preference(&tmp_route, rtnl_route_get_priority(route));
-
-			// next-hop container -> TODO: see what about special type
-			const int NEXTHOP_COUNT = rtnl_route_get_nnexthops(route);
-			if (NEXTHOP_COUNT == 1) {
-				struct rtnl_nexthop *nh = rtnl_route_nexthop_n(route, 0);
-				ifindex = rtnl_route_nh_get_ifindex(nh);
-				iface = rtnl_link_get(link_cache, ifindex);
-				if_name = xstrdup(rtnl_link_get_name(iface));
-				route_next_hop_set_simple(&tmp_route.next_hop, ifindex, if_name, rtnl_route_nh_get_gateway(nh));
-				rtnl_link_put(iface);
-			} else {
-				rtnl_route_foreach_nexthop(route, foreach_nexthop, &tmp_route.next_hop);
-			}
-
-			// route-metadata/source-protocol
-			route_set_source_protocol(&tmp_route, "ietf-routing:static");
+			routing_build_route(route, &tmp_route);
 
 			// add the route to the protocol's container
 			if (AF == AF_INET) {
@@ -276,24 +289,200 @@ static int static_routes_init(struct route_list_hash **ipv4_routes, struct route
 		route = (struct rtnl_route *) nl_cache_get_next((struct nl_object *) route);
 	}
 
-	goto out;
+	pthread_mutex_unlock(&routing_ribs_lock);
 
-error_out:
-	SRP_LOG_ERR("error initializing static routes");
-	error = -1;
-out:
-	nl_cache_free(cache);
-	nl_cache_free(link_cache);
-	nl_socket_free(socket);
-	return error;
+	return 0;
 }
 
 void sr_plugin_cleanup_cb(sr_session_ctx_t *session, void *private_data)
 {
+	routing_rib_cache_free();
+
 	route_list_hash_free(ipv4_static_routes);
 	route_list_hash_free(ipv6_static_routes);
 	FREE_SAFE(ipv4_static_routes);
 	FREE_SAFE(ipv6_static_routes);
+
+	route_strings_free();
+}
+
+static int routing_rib_cache_init(void)
+{
+	int error = 0;
+	int nl_err = 0;
+	struct rtnl_link *link = NULL;
+
+	rib_list_init(&routing_ribs);
+	link_names_init(&routing_link_names);
+
+	nl_err = rtnl_route_read_table_names("/etc/iproute2/rt_tables");
+	if (nl_err != 0) {
+		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	nl_err = rtnl_route_read_protocol_names("/etc/iproute2/rt_protos");
+	if (nl_err != 0) {
+		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	nl_err = nl_cache_mngr_alloc(NULL, NETLINK_ROUTE, 0, &routing_cache_manager);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_cache_mngr_alloc failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	// links first - needed for resolving next-hop interface names of the routes
+	nl_err = nl_cache_mngr_add(routing_cache_manager, "route/link", routing_link_change_cb, NULL, &routing_link_cache);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_cache_mngr_add failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	link = (struct rtnl_link *) nl_cache_get_first(routing_link_cache);
+	while (link != NULL) {
+		link_names_set(&routing_link_names, rtnl_link_get_ifindex(link), rtnl_link_get_name(link));
+		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
+	}
+
+	nl_err = nl_cache_mngr_add(routing_cache_manager, "route/route", routing_route_change_cb, NULL, &routing_route_cache);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_cache_mngr_add failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	// caches are filled when added to the manager - build the RIBs from them once, events update them later on
+	error = routing_collect_routes(routing_route_cache, &routing_ribs);
+	if (error != 0) {
+		goto error_out;
+	}
+
+	routing_cache_manager_exit = 0;
+	error = pthread_create(&routing_cache_manager_thread, NULL, routing_cache_manager_thread_cb, NULL);
+	if (error != 0) {
+		SRP_LOG_ERR("unable to start the cache manager thread (%d)", error);
+		goto error_out;
+	}
+
+	goto out;
+
+error_out:
+	SRP_LOG_ERR("error loading RIBs");
+	error = -1;
+	rib_list_free(&routing_ribs);
+	rib_list_init(&routing_ribs);
+	link_names_free(&routing_link_names);
+	if (routing_cache_manager) {
+		nl_cache_mngr_free(routing_cache_manager);
+		routing_cache_manager = NULL;
+	}
+
+out:
+	return error;
+}
+
+static void routing_rib_cache_free(void)
+{
+	if (routing_cache_manager) {
+		routing_cache_manager_exit = 1;
+		pthread_join(routing_cache_manager_thread, NULL);
+
+		// frees the managed caches as well
+		nl_cache_mngr_free(routing_cache_manager);
+		routing_cache_manager = NULL;
+		routing_route_cache = NULL;
+		routing_link_cache = NULL;
+	}
+
+	rib_list_free(&routing_ribs);
+	rib_list_init(&routing_ribs);
+	link_names_free(&routing_link_names);
+}
+
+static void *routing_cache_manager_thread_cb(void *data)
+{
+	struct pollfd pfd = {
+		.fd = nl_cache_mngr_get_fd(routing_cache_manager),
+		.events = POLLIN,
+	};
+	int nl_err = 0;
+
+	while (routing_cache_manager_exit == 0) {
+		// wait without the lock, process the received events with it
+		if (poll(&pfd, 1, 1000) > 0) {
+			pthread_mutex_lock(&routing_ribs_lock);
+			nl_err = nl_cache_mngr_data_ready(routing_cache_manager);
+			pthread_mutex_unlock(&routing_ribs_lock);
+
+			if (nl_err < 0) {
+				SRP_LOG_ERR("nl_cache_mngr_data_ready failed (%d): %s", nl_err, nl_geterror(nl_err));
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// apply a single RTM_NEWROUTE/RTM_DELROUTE to the RIBs - called by the cache manager with routing_ribs_lock held
+static void routing_route_change_cb(struct nl_cache *cache, struct nl_object *obj, int action, void *arg)
+{
+	struct rtnl_route *route = (struct rtnl_route *) obj;
+	struct route tmp_route = {0};
+	struct rib *rib = NULL;
+	char table_buffer[32] = {0};
+	const uint8_t AF = rtnl_route_get_family(route);
+	struct nl_addr *dst = rtnl_route_get_dst(route);
+
+	if ((AF != AF_INET && AF != AF_INET6) || dst == NULL) {
+		return;
+	}
+
+	rtnl_route_table2str((int) rtnl_route_get_table(route), table_buffer, sizeof(table_buffer));
+	rib = rib_list_get(&routing_ribs, table_buffer, AF);
+
+	switch (action) {
+		case NL_ACT_NEW:
+		case NL_ACT_CHANGE:
+			if (rib == NULL) {
+				rib_list_add(&routing_ribs, table_buffer, AF);
+				if (strncmp(table_buffer, "main", sizeof("main") - 1) == 0) {
+					rib_list_set_default(&routing_ribs, table_buffer, AF, 1);
+				}
+				rib = rib_list_get(&routing_ribs, table_buffer, AF);
+			}
+
+			// routes of a prefix in a table are identified by their metric, tos and type - replace the old one if it exists
+			rib_remove_route(rib, dst, rtnl_route_get_priority(route), rtnl_route_get_tos(route), rtnl_route_get_type(route));
+			routing_build_route(route, &tmp_route);
+			rib_add_route(rib, dst, &tmp_route);
+			break;
+		case NL_ACT_DEL:
+			if (rib != NULL) {
+				rib_remove_route(rib, dst, rtnl_route_get_priority(route), rtnl_route_get_tos(route), rtnl_route_get_type(route));
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+// keep the ifindex -> name table in sync with the links - called by the cache manager with routing_ribs_lock held
+static void routing_link_change_cb(struct nl_cache *cache, struct nl_object *obj, int action, void *arg)
+{
+	struct rtnl_link *link = (struct rtnl_link *) obj;
+
+	switch (action) {
+		case NL_ACT_NEW:
+		case NL_ACT_CHANGE:
+			link_names_set(&routing_link_names, rtnl_link_get_ifindex(link), rtnl_link_get_name(link));
+			break;
+		case NL_ACT_DEL:
+			link_names_remove(&routing_link_names, rtnl_link_get_ifindex(link));
+			break;
+		default:
+			break;
+	}
 }
 
 static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *xpath, sr_event_t event, uint32_t request_id, void *private_data)
@@ -315,9 +504,6 @@ static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscrip
 	char *node_xpath = NULL;
 	char *node_value = NULL;
 
-	bool ipv4_update = false;
-	bool ipv6_update = false;
-
 	SRP_LOG_INF("module_name: %s, xpath: %s, event: %d, request_id: %u", module_name, xpath, event, request_id);
 
 	if (event == SR_EV_ABORT) {
@@ -347,12 +533,6 @@ static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscrip
 			SRP_LOG_DBG("node_xpath: %s; prev_val: %s; node_val: %s; operation: %d", node_xpath, prev_value, node_value, operation);
 
 			if (node->schema->nodetype == LYS_LEAF || node->schema->nodetype == LYS_LEAFLIST) {
-				if (strstr(node_xpath, "ietf-ipv4-unicast-routing:ipv4")) {
-					ipv4_update = true;
-				} else if (strstr(node_xpath, "ietf-ipv6-unicast-routing:ipv6")) {
-					ipv6_update = true;
-				}
-
 				if (operation == SR_OP_CREATED || operation == SR_OP_MODIFIED) {
 					if (strstr(node_xpath, "/ietf-routing:routing/ribs")) {
 						error = set_rib_value(node_xpath, node_value);
@@ -387,7 +567,8 @@ static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscrip
 			FREE_SAFE(node_value);
 		}
 
-		if (ipv4_update) {
+		// static route changes mark their prefixes dirty - only those are applied
+		if (ipv4_static_routes->dirty_count) {
 			error = update_static_routes(ipv4_static_routes, AF_INET);
 			if (error) {
 				SRP_LOG_ERR("failed to update IPv4 static routes on system");
@@ -396,7 +577,7 @@ static int routing_module_change_cb(sr_session_ctx_t *session, uint32_t subscrip
 			route_list_hash_prune(ipv4_static_routes);
 		}
 
-		if (ipv6_update) {
+		if (ipv6_static_routes->dirty_count) {
 			error = update_static_routes(ipv6_static_routes, AF_INET6);
 			if (error) {
 				SRP_LOG_ERR("failed to update IPv6 static routes on system");
@@ -413,40 +594,68 @@ error_out:
 	FREE_SAFE(node_xpath);
 	FREE_SAFE(node_value);
 
+	// sysrepo aborts the change - drop its deletion marks and dirty prefixes instead of keeping them for the next one
+	static_routes_rollback(ipv4_static_routes, AF_INET);
+	static_routes_rollback(ipv6_static_routes, AF_INET6);
+
 out:
 	sr_free_change_iter(routing_change_iter);
 
 	return error != 0 ? SR_ERR_CALLBACK_FAILED : SR_ERR_OK;
 }
 
+// apply the dirty prefixes which differ from the installed routes
+// all changes are sent as one batch of netlink requests - failed requests are reported by their prefix
 static int update_static_routes(struct route_list_hash *routes, uint8_t family)
 {
-	struct nl_sock *socket = NULL;
+	struct route_batch batch = {0};
+	struct route_list_hash installed = {0};
 	struct rtnl_route *route = NULL;
 	struct rtnl_nexthop *next_hop = NULL;
 	struct nl_addr *dst_addr = NULL;
 	int error = 0;
-	int nl_err = 0;
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		error = -1;
-		SRP_LOG_ERR("unable to init nl_sock struct...");
+	route_list_hash_init(&installed);
+
+	// the RIBs follow the kernel asynchronously - a route deleted by a previous change can still be in them
+	error = static_routes_load_installed(family, &installed);
+	if (error != 0) {
+		SRP_LOG_ERR("unable to load the installed static routes");
 		goto error_out;
 	}
 
-	nl_err = nl_connect(socket, NETLINK_ROUTE);
-	if (nl_err != 0) {
-		error = -1;
-		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
+	error = route_batch_init(&batch);
+	if (error != 0) {
+		SRP_LOG_ERR("route_batch_init failed");
 		goto error_out;
 	}
 
-	for (size_t i = 0; i < routes->size; i++) {
+	for (size_t dirty_iter = 0; dirty_iter < routes->dirty_count; dirty_iter++) {
+		const size_t i = routes->dirty_list[dirty_iter];
+		const bool DELETE = routes->list_route[i].delete;
+		bool is_installed = false;
+
 		if (route_list_is_empty(&routes->list_route[i])) {
 			continue;
 		}
 
+		// a deleted route only needs to be installed at its preference, a kept one with the configured next hops as well
+		is_installed = static_route_is_installed(&installed, routes->list_addr[i], &routes->list_route[i].list[0], !DELETE);
+
+		// deleted route which isn't in the kernel (anymore)
+		if (DELETE && !is_installed) {
+			continue;
+		}
+
+		// kept route which is already installed (e.g. only the description changed)
+		if (!DELETE && is_installed) {
+			error = static_routes_delete_stale(&batch, &installed, routes->list_addr[i], routes->list_route[i].list[0].preference, family);
+			if (error != 0) {
+				goto error_out;
+			}
+			continue;
+		}
+
 		route = rtnl_route_alloc();
 		if (route == NULL) {
 			error = -1;
@@ -461,14 +670,14 @@ static int update_static_routes(struct route_list_hash *routes, uint8_t family)
 		rtnl_route_set_dst(route, dst_addr);
 		rtnl_route_set_priority(route, routes->list_route[i].list[0].preference);
 
-		if (routes->list_route[i].delete) {
+		if (DELETE) {
 			rtnl_route_set_scope(route, RT_SCOPE_NOWHERE);
-			nl_err = rtnl_route_delete(socket, route, 0);
-			if (nl_err != 0) {
-				error = -1;
-				SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
+			error = route_batch_delete(&batch, route, 0);
+			if (error != 0) {
 				goto error_out;
 			}
+			nl_addr_put(dst_addr);
+			dst_addr = NULL;
 			rtnl_route_put(route);
 			route = NULL;
 			continue;
@@ -513,10 +722,8 @@ static int update_static_routes(struct route_list_hash *routes, uint8_t family)
 
 		rtnl_route_set_scope(route, rtnl_route_guess_scope(route));
 
-		nl_err = rtnl_route_add(socket, route, NLM_F_REPLACE);
-		if (nl_err != 0) {
-			error = -1;
-			SRP_LOG_ERR("rtnl_route_add failed (%d): %s", nl_err, nl_geterror(nl_err));
+		error = route_batch_add(&batch, route, NLM_F_REPLACE);
+		if (error != 0) {
 			goto error_out;
 		}
 
@@ -524,7 +731,19 @@ static int update_static_routes(struct route_list_hash *routes, uint8_t family)
 		dst_addr = NULL;
 		rtnl_route_put(route);
 		route = NULL;
+
+		// deleted after the new route is added so that the prefix stays reachable
+		error = static_routes_delete_stale(&batch, &installed, routes->list_addr[i], routes->list_route[i].list[0].preference, family);
+		if (error != 0) {
+			goto error_out;
+		}
 	}
+
+	error = route_batch_commit(&batch);
+	if (error != 0) {
+		SRP_LOG_ERR("%zu static route changes failed", batch.errors);
+	}
+
 error_out:
 	if (dst_addr) {
 		nl_addr_put(dst_addr);
@@ -534,13 +753,241 @@ error_out:
 		rtnl_route_put(route);
 	}
 
-	if (socket) {
-		nl_socket_free(socket);
-	}
+	route_batch_free(&batch);
+	route_list_hash_free(&installed);
 
 	return error;
 }
 
+// the kernel keys routes by their metric - NLM_F_REPLACE at a changed preference adds a second route
+// instead of replacing the installed one, so the routes of dst at other preferences are deleted explicitly
+static int static_routes_delete_stale(struct route_batch *batch, struct route_list_hash *installed, struct nl_addr *dst, uint32_t preference, uint8_t family)
+{
+	struct route_list *routes = route_list_hash_get_by_addr(installed, dst);
+	struct rtnl_route *route = NULL;
+	int error = 0;
+
+	for (size_t i = 0; routes != NULL && i < routes->size; i++) {
+		if (routes->list[i].preference == preference) {
+			continue;
+		}
+
+		route = rtnl_route_alloc();
+		if (route == NULL) {
+			SRP_LOG_ERR("unable to alloc rtnl_route struct");
+			return -1;
+		}
+
+		rtnl_route_set_table(route, RT_TABLE_MAIN);
+		rtnl_route_set_protocol(route, RTPROT_STATIC);
+		rtnl_route_set_family(route, family);
+		rtnl_route_set_dst(route, dst);
+		rtnl_route_set_priority(route, routes->list[i].preference);
+		rtnl_route_set_scope(route, RT_SCOPE_NOWHERE);
+
+		error = route_batch_delete(batch, route, 0);
+		rtnl_route_put(route);
+		if (error != 0) {
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+// drop the pending changes of a failed transaction - the dirty prefixes are reset to the routes installed in the kernel,
+// which the static routes are initialized from, and prefixes without an installed route are removed
+static void static_routes_rollback(struct route_list_hash *routes, uint8_t family)
+{
+	struct route_list_hash installed = {0};
+	struct route tmp_route = {0};
+
+	if (routes->dirty_count == 0) {
+		return;
+	}
+
+	route_list_hash_init(&installed);
+
+	if (static_routes_load_installed(family, &installed) != 0) {
+		SRP_LOG_ERR("unable to load the installed static routes - changed prefixes are removed");
+	}
+
+	for (size_t dirty_iter = 0; dirty_iter < routes->dirty_count; dirty_iter++) {
+		const size_t i = routes->dirty_list[dirty_iter];
+		struct route_list *ls = &routes->list_route[i];
+		struct route_list *installed_ls = NULL;
+
+		if (routes->list_addr[i] == NULL) {
+			continue;
+		}
+
+		installed_ls = route_list_hash_get_by_addr(&installed, routes->list_addr[i]);
+
+		// the configured route is replaced by the installed one - route_list_free() clears the deletion mark as well
+		route_list_free(ls);
+		if (installed_ls == NULL || installed_ls->size == 0) {
+			ls->delete = true;
+			continue;
+		}
+
+		tmp_route = route_clone(&installed_ls->list[0]);
+		route_list_add(ls, &tmp_route);
+	}
+
+	// removes the prefixes marked above and clears the dirty set
+	route_list_hash_prune(routes);
+	route_list_hash_free(&installed);
+}
+
+// static routes of the main table as currently installed in the kernel - a single RTM_GETROUTE dump,
+// filtered by the kernel to the main table and the static protocol if it supports strict dump checking
+static int static_routes_load_installed(uint8_t family, struct route_list_hash *installed)
+{
+	struct nl_sock *socket = NULL;
+	struct rtmsg rtm = {
+		.rtm_family = family,
+		.rtm_table = RT_TABLE_MAIN,
+		.rtm_protocol = RTPROT_STATIC,
+	};
+	const int ONE = 1;
+	int nl_err = 0;
+
+	socket = nl_socket_alloc();
+	if (socket == NULL) {
+		SRP_LOG_ERR("unable to init nl_sock struct...");
+		return -1;
+	}
+
+	nl_err = nl_connect(socket, NETLINK_ROUTE);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	// older kernels ignore the filter and dump all routes - static_routes_installed_cb filters them as well
+	if (setsockopt(nl_socket_get_fd(socket), SOL_NETLINK, NETLINK_GET_STRICT_CHK, &ONE, sizeof(ONE)) != 0) {
+		SRP_LOG_DBG("NETLINK_GET_STRICT_CHK not supported: %s", strerror(errno));
+	}
+
+	nl_err = nl_socket_modify_cb(socket, NL_CB_VALID, NL_CB_CUSTOM, static_routes_installed_cb, installed);
+	if (nl_err != 0) {
+		SRP_LOG_ERR("nl_socket_modify_cb failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	nl_err = nl_send_simple(socket, RTM_GETROUTE, NLM_F_DUMP, &rtm, sizeof(rtm));
+	if (nl_err < 0) {
+		SRP_LOG_ERR("nl_send_simple failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	nl_err = nl_recvmsgs_default(socket);
+	if (nl_err < 0) {
+		SRP_LOG_ERR("nl_recvmsgs_default failed (%d): %s", nl_err, nl_geterror(nl_err));
+		goto error_out;
+	}
+
+	nl_socket_free(socket);
+
+	return 0;
+
+error_out:
+	nl_socket_free(socket);
+
+	return -1;
+}
+
+static int static_routes_installed_cb(struct nl_msg *msg, void *arg)
+{
+	struct route_list_hash *installed = arg;
+	struct rtnl_route *route = NULL;
+	struct route tmp_route = {0};
+
+	if (rtnl_route_parse(nlmsg_hdr(msg), &route) != 0) {
+		return NL_SKIP;
+	}
+
+	if (rtnl_route_get_table(route) == RT_TABLE_MAIN && rtnl_route_get_protocol(route) == RTPROT_STATIC && rtnl_route_get_dst(route) != NULL) {
+		// next-hop names are resolved from the shared ifindex table
+		pthread_mutex_lock(&routing_ribs_lock);
+		routing_build_route(route, &tmp_route);
+		pthread_mutex_unlock(&routing_ribs_lock);
+
+		route_list_hash_add(installed, rtnl_route_get_dst(route), &tmp_route);
+		route_free(&tmp_route);
+	}
+
+	rtnl_route_put(route);
+
+	return NL_OK;
+}
+
+// check the installed static routes for the configured one - next hops are compared only if requested
+static bool static_route_is_installed(struct route_list_hash *installed, struct nl_addr *dst, const struct route *route, bool compare_next_hop)
+{
+	struct route_list *routes = route_list_hash_get_by_addr(installed, dst);
+	bool found = false;
+
+	for (size_t i = 0; routes != NULL && i < routes->size && !found; i++) {
+		const struct route *ROUTE = &routes->list[i];
+
+		found = ROUTE->preference == route->preference && (!compare_next_hop || static_route_next_hop_matches(&route->next_hop, &ROUTE->next_hop));
+	}
+
+	return found;
+}
+
+// outgoing interface of a configured simple next hop is optional - the kernel resolves it from the gateway
+static bool static_route_next_hop_matches(const struct route_next_hop *config, const struct route_next_hop *installed)
+{
+	if (config->kind != installed->kind) {
+		return false;
+	}
+
+	switch (config->kind) {
+		case route_next_hop_kind_simple: {
+			const struct route_next_hop_simple *CONFIG = &config->value.simple;
+			const struct route_next_hop_simple *INSTALLED = &installed->value.simple;
+
+			if (CONFIG->ifindex != 0 && CONFIG->ifindex != INSTALLED->ifindex) {
+				return false;
+			}
+
+			if (CONFIG->addr == NULL || INSTALLED->addr == NULL) {
+				return CONFIG->addr == INSTALLED->addr;
+			}
+
+			return nl_addr_cmp(CONFIG->addr, INSTALLED->addr) == 0;
+		}
+		case route_next_hop_kind_list: {
+			const struct route_next_hop_list *CONFIG = &config->value.list;
+			const struct route_next_hop_list *INSTALLED = &installed->value.list;
+
+			if (CONFIG->size != INSTALLED->size) {
+				return false;
+			}
+
+			for (size_t i = 0; i < CONFIG->size; i++) {
+				if (CONFIG->list[i].ifindex != INSTALLED->list[i].ifindex) {
+					return false;
+				}
+
+				if (CONFIG->list[i].addr == NULL || INSTALLED->list[i].addr == NULL) {
+					if (CONFIG->list[i].addr != INSTALLED->list[i].addr) {
+						return false;
+					}
+				} else if (nl_addr_cmp(CONFIG->list[i].addr, INSTALLED->list[i].addr) != 0) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
 static int set_control_plane_protocol_value(char *node_xpath, char *node_value)
 {
 	sr_xpath_ctx_t xpath_ctx = {0};
@@ -623,7 +1070,10 @@ static int set_static_route_value(char *xpath, char *node_name, char *node_value
 	}
 
 	if (next_hop_list != NULL) {
-		route_list->list[0].next_hop.kind = route_next_hop_kind_list;
+		// initializes the list fields as well - setting only the kind would leave the union half filled
+		if (route_list->list[0].next_hop.kind == route_next_hop_kind_none) {
+			route_next_hop_reserve_list(&route_list->list[0].next_hop, 0);
+		}
 
 		if (!strcmp(node_name, "next-hop-address")) {
 		} else if (!strcmp(node_name, "outgoing-interface")) {
@@ -648,6 +1098,8 @@ static int set_static_route_value(char *xpath, char *node_name, char *node_value
 		}
 	}
 
+	route_list_hash_mark_dirty(routes_hash, destination_prefix_addr);
+
 out:
 	if (destination_prefix_addr) {
 		nl_addr_put(destination_prefix_addr);
@@ -777,7 +1229,10 @@ static int delete_static_route_value(char *xpath, char *node_name, int family)
 	}
 
 	if (next_hop_list != NULL) {
-		route_list->list[0].next_hop.kind = route_next_hop_kind_list;
+		// initializes the list fields as well - setting only the kind would leave the union half filled
+		if (route_list->list[0].next_hop.kind == route_next_hop_kind_none) {
+			route_next_hop_reserve_list(&route_list->list[0].next_hop, 0);
+		}
 
 		if (!strcmp(node_name, "next-hop-address")) {
 		} else if (!strcmp(node_name, "outgoing-interface")) {
@@ -787,11 +1242,20 @@ static int delete_static_route_value(char *xpath, char *node_name, int family)
 	} else if (!strcmp(node_name, "description")) {
 		set_static_route_description(route_list, NULL);
 	} else if (!strcmp(node_name, "next-hop-address")) {
+		if (route_list->list[0].next_hop.value.simple.addr) {
+			nl_addr_put(route_list->list[0].next_hop.value.simple.addr);
+		}
 		route_list->list[0].next_hop.value.simple.addr = NULL;
 	} else if (!strcmp(node_name, "outgoing-interface")) {
-		route_list->list[0].next_hop.value.simple.if_name = NULL;
+		if (route_list->list[0].next_hop.value.simple.if_name) {
+			FREE_SAFE(route_list->list[0].next_hop.value.simple.if_name);
+		}
+		// compared against the installed routes - the interface is no longer part of the config
+		route_list->list[0].next_hop.value.simple.ifindex = 0;
 	}
 
+	route_list_hash_mark_dirty(family == AF_INET ? ipv4_static_routes : ipv6_static_routes, destination_prefix_addr);
+
 out:
 	if (destination_prefix_addr) {
 		nl_addr_put(destination_prefix_addr);
@@ -1081,6 +1545,55 @@ static char *routing_xpath_get(const struct lyd_node *node)
 	}
 }
 
+// value of the key predicate of a list node in the xpath - module prefixes of the node and key names are ignored
+// returns NULL if the xpath doesn't select the list instance by the key
+static char *routing_xpath_predicate_get(const char *xpath, const char *node_name, const char *key_name)
+{
+	const size_t NODE_LEN = strlen(node_name);
+	const size_t KEY_LEN = strlen(key_name);
+	const char *node = xpath;
+
+	while ((node = strstr(node, node_name)) != NULL) {
+		const char *predicate = node + NODE_LEN;
+
+		// whole node names only - "rib" must not match "ribs"
+		if ((node == xpath || node[-1] == '/' || node[-1] == ':') && *predicate == '[') {
+			while (*predicate == '[') {
+				const char *name = predicate + 1;
+				const char *equal = strchr(name, '=');
+				const char *colon = NULL;
+				const char *value = NULL;
+				const char *end = NULL;
+
+				if (equal == NULL || (equal[1] != '\'' && equal[1] != '"')) {
+					return NULL;
+				}
+
+				colon = memchr(name, ':', (size_t) (equal - name));
+				if (colon != NULL) {
+					name = colon + 1;
+				}
+
+				value = equal + 2;
+				end = strchr(value, equal[1]);
+				if (end == NULL || end[1] != ']') {
+					return NULL;
+				}
+
+				if ((size_t) (equal - name) == KEY_LEN && strncmp(name, key_name, KEY_LEN) == 0) {
+					return xstrndup(value, (size_t) (end - value));
+				}
+
+				predicate = end + 2;
+			}
+		}
+
+		node += NODE_LEN;
+	}
+
+	return NULL;
+}
+
 static int routing_oper_get_interfaces_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
 {
 	// error handling
@@ -1091,10 +1604,11 @@ static int routing_oper_get_interfaces_cb(sr_session_ctx_t *session, uint32_t su
 	const struct ly_ctx *ly_ctx = NULL;
 
 	// libnl
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
 	struct rtnl_link *link = NULL;
 
+	// links are kept up to date by the cache manager
+	pthread_mutex_lock(&routing_ribs_lock);
+
 	if (*parent == NULL) {
 		ly_ctx = sr_get_context(sr_session_get_connection(session));
 		if (ly_ctx == NULL) {
@@ -1107,368 +1621,478 @@ static int routing_oper_get_interfaces_cb(sr_session_ctx_t *session, uint32_t su
 		}
 	}
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("unable to init nl_sock struct...");
-		goto error_out;
+	SRP_LOG_DBG("adding interfaces to the list");
+
+	link = (struct rtnl_link *) nl_cache_get_first(routing_link_cache);
+	while (link) {
+		const char *name = rtnl_link_get_name(link);
+		SRP_LOG_DBG("adding interface '%s' ", name);
+		ly_err = lyd_new_path(*parent, ly_ctx, ROUTING_INTERFACE_LEAF_LIST_YANG_PATH, (void *) name, 0, NULL);
+		if (ly_err != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new interface node");
+			goto error_out;
+		}
+
+		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
 	}
 
-	error = nl_connect(socket, NETLINK_ROUTE);
-	if (error != 0) {
-		SRP_LOG_ERR("nl_connect failed (%d): %s", error, nl_geterror(error));
-		goto error_out;
+	goto out;
+
+error_out:
+	error = SR_ERR_CALLBACK_FAILED;
+out:
+	pthread_mutex_unlock(&routing_ribs_lock);
+
+	return error;
+}
+
+// called with routing_ribs_lock held - names are resolved from the shared ifindex table
+static void foreach_nexthop(struct rtnl_nexthop *nh, void *arg)
+{
+	struct route_next_hop *nexthop = arg;
+	const int IFINDEX = rtnl_route_nh_get_ifindex(nh);
+	const char *if_name = link_names_get(&routing_link_names, IFINDEX);
+
+	// the outgoing-interface leaf is left out if the link is already gone
+	route_next_hop_add_list(nexthop, IFINDEX, if_name, rtnl_route_nh_get_gateway(nh));
+}
+
+// RIB list entries only - their routes are added by routing_oper_get_rib_routes_cb
+static int routing_oper_get_ribs_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = SR_ERR_OK;
+	LY_ERR ly_err = LY_SUCCESS;
+
+	// libyang
+	const struct ly_ctx *ly_ctx = NULL;
+
+	// request filters
+	char *rib_filter = NULL;
+
+	// temp buffers
+	char rib_name_buffer[32 + 5];
+	char rib_buffer[PATH_MAX];
+
+	ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+	// create only the requested RIB if the request selects one
+	if (request_xpath != NULL) {
+		rib_filter = routing_xpath_predicate_get(request_xpath, "rib", "name");
+		SRP_LOG_DBG("RIB filter: %s", rib_filter);
 	}
 
-	error = rtnl_link_alloc_cache(socket, AF_UNSPEC, &cache);
-	if (error != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache failed (%d): %s", error, nl_geterror(error));
+	pthread_mutex_lock(&routing_ribs_lock);
+
+	for (size_t hash_iter = 0; hash_iter < routing_ribs.size; hash_iter++) {
+		const int ADDR_FAMILY = routing_ribs.list[hash_iter].address_family;
+		const char *TABLE_NAME = routing_ribs.list[hash_iter].name;
+
+		snprintf(rib_name_buffer, sizeof(rib_name_buffer), "%s-%s", ADDR_FAMILY == AF_INET ? "ipv4" : "ipv6", TABLE_NAME);
+		if (rib_filter != NULL && strcmp(rib_filter, rib_name_buffer) != 0) {
+			continue;
+		}
+
+		// the first created node becomes the parent if sysrepo didn't provide one
+		snprintf(rib_buffer, sizeof(rib_buffer), "%s[name='%s']", ROUTING_RIB_LIST_YANG_PATH, rib_name_buffer);
+		ly_err = lyd_new_path(*parent, ly_ctx, rib_buffer, NULL, LYD_NEW_PATH_UPDATE, *parent ? NULL : parent);
+		if (ly_err != LY_SUCCESS) {
+			SRP_LOG_ERR("unable to create new RIB node");
+			goto error_out;
+		}
+	}
+
+	goto out;
+
+error_out:
+	error = SR_ERR_CALLBACK_FAILED;
+
+out:
+	pthread_mutex_unlock(&routing_ribs_lock);
+
+	if (rib_filter) {
+		FREE_SAFE(rib_filter);
+	}
+
+	return error;
+}
+
+// called once per RIB entry - the parent is the rib list node
+static int routing_oper_get_rib_routes_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+	int error = SR_ERR_OK;
+	LY_ERR ly_err = LY_SUCCESS;
+
+	// libyang
+	const struct ly_ctx *ly_ctx = NULL;
+	struct lyd_node *name_node = NULL, *routes_node = NULL;
+
+	// RIB
+	struct rib *rib = NULL;
+	const struct route_list_hash *routes_hash = NULL;
+	size_t routes_begin = 0;
+	size_t routes_end = 0;
+	const char *rib_name = NULL;
+	char table_name[32] = {0};
+	int addr_family = 0;
+
+	// request filters
+	char *prefix_filter = NULL;
+
+	ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+	if (*parent == NULL || lyd_find_path(*parent, "name", false, &name_node) != LY_SUCCESS) {
+		return SR_ERR_OK;
+	}
+
+	// RIB names are the address family and the table name - "ipv4-main"
+	rib_name = lyd_get_value(name_node);
+	if (strncmp(rib_name, "ipv4-", 5) == 0) {
+		addr_family = AF_INET;
+	} else if (strncmp(rib_name, "ipv6-", 5) == 0) {
+		addr_family = AF_INET6;
+	} else {
+		return SR_ERR_OK;
+	}
+	snprintf(table_name, sizeof(table_name), "%s", rib_name + 5);
+
+	// serialize only the requested destination prefix if the request selects one
+	if (request_xpath != NULL) {
+		prefix_filter = routing_xpath_predicate_get(request_xpath, "route", "destination-prefix");
+		SRP_LOG_DBG("RIB: %s; destination-prefix filter: %s", rib_name, prefix_filter);
+	}
+
+	// RIBs are kept up to date by the cache manager - only serialize them here
+	pthread_mutex_lock(&routing_ribs_lock);
+
+	// route schema nodes are resolved once - again only if the context changes
+	if (routing_rib_schema.ly_ctx != ly_ctx) {
+		error = rib_tree_schema_init(&routing_rib_schema, ly_ctx);
+		if (error != 0) {
+			goto error_out;
+		}
+	}
+
+	// RIB configured but no longer in the kernel
+	rib = rib_list_get(&routing_ribs, table_name, addr_family);
+	if (rib == NULL) {
+		goto out;
+	}
+
+	routes_hash = &rib->routes;
+	routes_end = routes_hash->size;
+
+	// requested prefix - looked up directly in the RIB hash
+	if (prefix_filter != NULL) {
+		const struct route_list *PREFIX_ROUTES = routing_rib_get_prefix(rib, prefix_filter);
+		if (PREFIX_ROUTES == NULL) {
+			goto out;
+		}
+		routes_begin = (size_t) (PREFIX_ROUTES - routes_hash->list_route);
+		routes_end = routes_begin + 1;
+	}
+
+	ly_err = lyd_new_inner(*parent, NULL, "routes", false, &routes_node);
+	if (ly_err != LY_SUCCESS) {
+		SRP_LOG_ERR("unable to create new routes node");
 		goto error_out;
 	}
 
-	SRP_LOG_DBG("adding interfaces to the list");
+	for (size_t i = routes_begin; i < routes_end; i++) {
+		// position freed by a removed prefix
+		if (routes_hash->list_addr[i] == NULL) {
+			continue;
+		}
 
-	link = (struct rtnl_link *) nl_cache_get_first(cache);
-	while (link) {
-		const char *name = rtnl_link_get_name(link);
-		SRP_LOG_DBG("adding interface '%s' ", name);
-		ly_err = lyd_new_path(*parent, ly_ctx, ROUTING_INTERFACE_LEAF_LIST_YANG_PATH, (void *) name, 0, NULL);
-		if (ly_err != LY_SUCCESS) {
-			SRP_LOG_ERR("unable to create new interface node");
+		error = rib_tree_add_route_list(&routing_rib_schema, routes_node, addr_family, routes_hash->list_addr[i], &routes_hash->list_route[i], &routing_link_names);
+		if (error != 0) {
 			goto error_out;
 		}
-
-		link = (struct rtnl_link *) nl_cache_get_next((struct nl_object *) link);
 	}
 
 	goto out;
 
 error_out:
+	SRP_LOG_ERR("unable to return routes for routing table %s", rib_name);
 	error = SR_ERR_CALLBACK_FAILED;
+
 out:
-	// free allocated objects
-	nl_cache_free(cache);
-	nl_socket_free(socket);
+	pthread_mutex_unlock(&routing_ribs_lock);
+
+	if (prefix_filter) {
+		FREE_SAFE(prefix_filter);
+	}
 
 	return error;
 }
 
-static void foreach_nexthop(struct rtnl_nexthop *nh, void *arg)
+// routes of the prefix given in the destination-prefix format of the RIB address family
+static struct route_list *routing_rib_get_prefix(struct rib *rib, const char *prefix)
 {
-	struct route_next_hop *nexthop = arg;
-	struct nl_cache *link_cache = NULL;
-	struct nl_sock *socket = NULL;
-	struct rtnl_link *iface = NULL;
-	int ifindex = 0;
-	char *if_name = NULL;
+	struct nl_addr *addr = NULL;
+	struct route_list *routes = NULL;
 	int nl_err = 0;
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("unable to init nl_sock struct...");
-		return;
-	}
-
-	nl_err = nl_connect(socket, NETLINK_ROUTE);
+	nl_err = nl_addr_parse(prefix, rib->address_family, &addr);
 	if (nl_err != 0) {
-		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
-		return;
+		SRP_LOG_ERR("failed to parse destination-prefix %s (%d): %s", prefix, nl_err, nl_geterror(nl_err));
+		return NULL;
 	}
 
-	nl_err = rtnl_link_alloc_cache(socket, AF_UNSPEC, &link_cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
-		return;
+	// default routes are stored with an empty destination address
+	if (nl_addr_get_prefixlen(addr) == 0) {
+		nl_addr_put(addr);
+		nl_err = nl_addr_parse("default", rib->address_family, &addr);
+		if (nl_err != 0) {
+			return NULL;
+		}
 	}
 
-	ifindex = rtnl_route_nh_get_ifindex(nh);
-	iface = rtnl_link_get(link_cache, ifindex);
-	if_name = xstrdup(rtnl_link_get_name(iface));
-
-	route_next_hop_add_list(nexthop, ifindex, if_name, rtnl_route_nh_get_gateway(nh));
+	routes = route_list_hash_get_by_addr(&rib->routes, addr);
+	nl_addr_put(addr);
 
-	rtnl_link_put(iface);
-	nl_cache_free(link_cache);
-	nl_socket_free(socket);
+	return routes;
 }
 
-static int routing_oper_get_rib_routes_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *module_name, const char *path, const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+static int routing_rpc_active_route_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *xpath, const sr_val_t *input, const size_t input_cnt, sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt, void *private_data)
 {
 	int error = SR_ERR_OK;
-	int nl_err = 0;
-	LY_ERR ly_err = LY_SUCCESS;
+	sr_xpath_ctx_t xpath_ctx = {0};
 
-	// libyang
-	const struct ly_ctx *ly_ctx = NULL;
-	const struct lys_module *ly_uv4mod = NULL, *ly_uv6mod = NULL;
-	struct lyd_node *ly_node = NULL, *routes_node = NULL, *nh_node = NULL, *nh_list_node = NULL;
+	// RIB and destination
+	char *xpath_copy = NULL;
+	char *rib_name = NULL;
+	const char *table_name = NULL;
+	const char *destination_address = NULL;
+	int family = AF_UNSPEC;
+	struct nl_addr *dst_addr = NULL;
+	struct nl_addr *dst_prefix = NULL;
+	struct rib *rib = NULL;
+	struct route_list *routes = NULL;
+	const struct route *active = NULL;
 
-	// libnl
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
-	struct nl_cache *link_cache = NULL;
-	struct rib_list ribs = {0};
+	// output
+	sr_val_t *values = NULL;
+	size_t values_cnt = 0;
+	size_t values_idx = 0;
+	const char *af_module = NULL;
 
 	// temp buffers
-	char routes_buffer[PATH_MAX];
-	char value_buffer[PATH_MAX];
-	char ip_buffer[INET6_ADDRSTRLEN];
-	char prefix_buffer[INET6_ADDRSTRLEN + 1 + 3];
-	char xpath_buffer[256] = {0};
+	char ip_buffer[INET6_ADDRSTRLEN] = {0};
+	char prefix_buffer[INET6_ADDRSTRLEN + 1 + 3] = {0};
+	char node_buffer[256] = {0};
 
-	ly_ctx = sr_get_context(sr_session_get_connection(session));
+	SRP_LOG_DBG("xpath for RPC: %s", xpath);
 
-	ly_uv4mod = ly_ctx_get_module(ly_ctx, "ietf-ipv4-unicast-routing", "2018-03-13");
-	ly_uv6mod = ly_ctx_get_module(ly_ctx, "ietf-ipv6-unicast-routing", "2018-03-13");
+	*output = NULL;
+	*output_cnt = 0;
 
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("unable to init nl_sock struct...");
+	// the looked up routes belong to the RIBs updated by the cache manager
+	pthread_mutex_lock(&routing_ribs_lock);
+
+	// RIB names are built as <address family>-<table name>
+	xpath_copy = xstrdup(xpath);
+	rib_name = sr_xpath_key_value(xpath_copy, "rib", "name", &xpath_ctx);
+	if (rib_name == NULL) {
+		SRP_LOG_ERR("unable to get RIB name from %s", xpath);
 		goto error_out;
 	}
 
-	nl_err = nl_connect(socket, NETLINK_ROUTE);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
+	if (strncmp(rib_name, "ipv4-", sizeof("ipv4-") - 1) == 0) {
+		family = AF_INET;
+		af_module = "ietf-ipv4-unicast-routing";
+	} else if (strncmp(rib_name, "ipv6-", sizeof("ipv6-") - 1) == 0) {
+		family = AF_INET6;
+		af_module = "ietf-ipv6-unicast-routing";
+	} else {
+		SRP_LOG_ERR("unsupported RIB %s", rib_name);
 		goto error_out;
 	}
+	table_name = rib_name + sizeof("ipv4-") - 1;
 
-	nl_err = rtnl_route_alloc_cache(socket, AF_UNSPEC, 0, &cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
+	for (size_t i = 0; i < input_cnt; i++) {
+		if (strcmp(sr_xpath_node_name(input[i].xpath), "destination-address") == 0) {
+			destination_address = input[i].data.string_val;
+			break;
+		}
+	}
+
+	if (destination_address == NULL) {
+		SRP_LOG_ERR("destination-address input parameter missing");
 		goto error_out;
 	}
 
-	nl_err = rtnl_link_alloc_cache(socket, AF_UNSPEC, &link_cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_link_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
+	error = nl_addr_parse(destination_address, family, &dst_addr);
+	if (error != 0) {
+		SRP_LOG_ERR("failed to parse destination-address %s (%d): %s", destination_address, error, nl_geterror(error));
 		goto error_out;
 	}
 
-	nl_err = rtnl_route_read_table_names("/etc/iproute2/rt_tables");
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
+	// no route for the destination -> no output
+	rib = rib_list_get(&routing_ribs, (char *) table_name, family);
+	if (rib == NULL) {
+		SRP_LOG_DBG("RIB %s not found", rib_name);
+		goto out;
+	}
+
+	routes = rib_lookup_route_list(rib, dst_addr, &dst_prefix);
+	if (routes == NULL || routes->size == 0) {
+		SRP_LOG_DBG("no active route for %s in RIB %s", destination_address, rib_name);
+		goto out;
+	}
+
+	active = &routes->list[0];
+	for (size_t i = 0; i < routes->size; i++) {
+		if (routes->list[i].metadata.active) {
+			active = &routes->list[i];
+			break;
+		}
+	}
+
+	// destination-prefix, source-protocol, active and next-hop nodes
+	values_cnt = 2u + (active->metadata.active ? 1u : 0u);
+	switch (active->next_hop.kind) {
+		case route_next_hop_kind_none:
+			break;
+		case route_next_hop_kind_simple:
+			values_cnt += (active->next_hop.value.simple.if_name ? 1u : 0u) + (active->next_hop.value.simple.addr ? 1u : 0u);
+			break;
+		case route_next_hop_kind_special:
+			values_cnt += 1;
+			break;
+		case route_next_hop_kind_list:
+			for (size_t i = 0; i < active->next_hop.value.list.size; i++) {
+				values_cnt += (active->next_hop.value.list.list[i].if_name ? 1u : 0u) + (active->next_hop.value.list.list[i].addr ? 1u : 0u);
+			}
+			break;
+	}
+
+	error = sr_new_values(values_cnt, &values);
+	if (error != SR_ERR_OK) {
+		SRP_LOG_ERR("sr_new_values error (%d): %s", error, sr_strerror(error));
 		goto error_out;
 	}
 
-	nl_err = rtnl_route_read_protocol_names("/etc/iproute2/rt_protos");
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
+	rib_prefix_to_str(dst_prefix, family, prefix_buffer, sizeof(prefix_buffer));
+	snprintf(node_buffer, sizeof(node_buffer), "%s:destination-prefix", af_module);
+	error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, node_buffer, SR_STRING_T, prefix_buffer);
+	if (error != SR_ERR_OK) {
 		goto error_out;
 	}
 
-	error = routing_collect_routes(cache, link_cache, &ribs);
-	if (error != 0) {
+	error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, "source-protocol", SR_IDENTITYREF_T, active->metadata.source_protocol);
+	if (error != SR_ERR_OK) {
 		goto error_out;
 	}
 
-	for (size_t hash_iter = 0; hash_iter < ribs.size; hash_iter++) {
-		// create new routes container for every table
-		const struct route_list_hash *ROUTES_HASH = &ribs.list[hash_iter].routes;
-		const int ADDR_FAMILY = ribs.list[hash_iter].address_family;
-		const char *TABLE_NAME = ribs.list[hash_iter].name;
-		snprintf(routes_buffer, sizeof(routes_buffer), "%s[name='%s-%s']/routes", ROUTING_RIB_LIST_YANG_PATH, ADDR_FAMILY == AF_INET ? "ipv4" : "ipv6", TABLE_NAME);
-		ly_err = lyd_new_path(*parent, ly_ctx, routes_buffer, NULL, LYD_NEW_PATH_UPDATE, &routes_node);
-		if (ly_err != LY_SUCCESS) {
-			SRP_LOG_ERR("unable to create new routes node");
+	if (active->metadata.active) {
+		error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, "active", SR_LEAF_EMPTY_T, NULL);
+		if (error != SR_ERR_OK) {
 			goto error_out;
 		}
+	}
 
-		for (size_t i = 0; i < ROUTES_HASH->size; i++) {
-			struct route_list *list_ptr = &ROUTES_HASH->list_route[i];
-			struct nl_addr *dst_prefix = ROUTES_HASH->list_addr[i];
-			nl_addr2str(dst_prefix, ip_buffer, sizeof(ip_buffer));
-
-			// check for prefix - libnl doesn't write prefix into the buffer if its 8*4/8*6 i.e. only that address/no subnet
-			if (strchr(ip_buffer, '/') == NULL) {
-				snprintf(prefix_buffer, sizeof(prefix_buffer), "%s/%d", ip_buffer, nl_addr_get_prefixlen(dst_prefix));
-			} else {
-				snprintf(prefix_buffer, sizeof(prefix_buffer), "%s", ip_buffer);
-			}
-
-			for (size_t j = 0; j < list_ptr->size; j++) {
-				const struct route *ROUTE = &list_ptr->list[j];
-				// create a new list and after that add properties to it
-				ly_err = lyd_new_path(routes_node, ly_ctx, "routes/route", NULL, 0, &ly_node);
-				if (ly_err != LY_SUCCESS) {
-					SRP_LOG_ERR("unable to create new route node");
-					goto error_out;
-				}
+	switch (active->next_hop.kind) {
+		case route_next_hop_kind_none:
+			break;
+		case route_next_hop_kind_simple: {
+			const struct route_next_hop_simple *NEXTHOP = &active->next_hop.value.simple;
 
-				// route-preference
-				snprintf(value_buffer, sizeof(value_buffer), "%u", ROUTE->preference);
-				SRP_LOG_DBG("route-preference = %s", value_buffer);
-				ly_err = lyd_new_path(ly_node, ly_ctx, "route-preference", (void *) value_buffer, 0, NULL);
-				if (ly_err != LY_SUCCESS) {
-					SRP_LOG_ERR("unable to create new route-preference node");
+			if (NEXTHOP->if_name) {
+				error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, "next-hop/outgoing-interface", SR_STRING_T, NEXTHOP->if_name);
+				if (error != SR_ERR_OK) {
 					goto error_out;
 				}
+			}
 
-				// next-hop container
-				const union route_next_hop_value *NEXTHOP = &ROUTE->next_hop.value;
-				ly_err = lyd_new_path(ly_node, ly_ctx, "next-hop", NULL, 0, &nh_node);
-				if (ly_err != LY_SUCCESS) {
-					SRP_LOG_ERR("unable to create new next-hop node");
+			if (NEXTHOP->addr) {
+				nl_addr2str(NEXTHOP->addr, ip_buffer, sizeof(ip_buffer));
+				snprintf(node_buffer, sizeof(node_buffer), "next-hop/%s:next-hop-address", af_module);
+				error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, node_buffer, SR_STRING_T, ip_buffer);
+				if (error != SR_ERR_OK) {
 					goto error_out;
 				}
-
-				switch (ROUTE->next_hop.kind) {
-					case route_next_hop_kind_none:
-						break;
-					case route_next_hop_kind_simple: {
-						struct rtnl_link *iface = rtnl_link_get(link_cache, ROUTE->next_hop.value.simple.ifindex);
-						const char *if_name = rtnl_link_get_name(iface);
-
-						// outgoing-interface
-						SRP_LOG_DBG("outgoing-interface = %s", if_name);
-						ly_err = lyd_new_path(nh_node, ly_ctx, "outgoing-interface", (void *) if_name, 0, NULL);
-						if (ly_err != LY_SUCCESS) {
-							SRP_LOG_ERR("unable to create new outgoing-interface node");
-							goto error_out;
-						}
-
-						// next-hop-address
-						if (NEXTHOP->simple.addr) {
-							nl_addr2str(NEXTHOP->simple.addr, ip_buffer, sizeof(ip_buffer));
-							if (ADDR_FAMILY == AF_INET && ly_uv4mod != NULL) {
-								SRP_LOG_DBG("IPv4 next-hop-address = %s", ip_buffer);
-								ly_err = lyd_new_term(nh_node, ly_uv4mod, "next-hop-address", ip_buffer, false, NULL);
-								if (ly_err != LY_SUCCESS) {
-									SRP_LOG_ERR("unable to create new IPv4 next-hop-address node");
-									goto error_out;
-								}
-							} else if (ADDR_FAMILY == AF_INET6 && ly_uv6mod != NULL) {
-								SRP_LOG_DBG("IPv6 next-hop-address = %s", ip_buffer);
-								ly_err = lyd_new_term(nh_node, ly_uv6mod, "next-hop-address", ip_buffer, false, NULL);
-								if (ly_err != LY_SUCCESS) {
-									SRP_LOG_ERR("unable to create new IPv6 next-hop-address node");
-									goto error_out;
-								}
-							}
-						}
-						rtnl_link_put(iface);
-						break;
-					}
-					case route_next_hop_kind_special:
-						break;
-					case route_next_hop_kind_list: {
-						const struct route_next_hop_list *NEXTHOP_LIST = &ROUTE->next_hop.value.list;
-
-						for (size_t k = 0; k < NEXTHOP_LIST->size; k++) {
-							struct rtnl_link *iface = rtnl_link_get(link_cache, NEXTHOP_LIST->list[k].ifindex);
-							const char *if_name = rtnl_link_get_name(iface);
-
-							error = snprintf(xpath_buffer, sizeof(xpath_buffer), "next-hop/next-hop-list/next-hop[index=%d]", NEXTHOP_LIST->list[k].ifindex);
-							if (error < 0) {
-								SRP_LOG_ERR("unable to create new next-hop-list/next-hop node, couldn't retrieve interface index");
-								goto error_out;
-							}
-							ly_err = lyd_new_path(nh_node, ly_ctx, xpath_buffer, NULL, 0, &nh_list_node);
-							if (ly_err != LY_SUCCESS) {
-								SRP_LOG_ERR("unable to create new next-hop-list/next-hop node");
-								goto error_out;
-							}
-
-							// outgoing-interface
-							SRP_LOG_DBG("outgoing-interface = %s", if_name);
-							ly_err = lyd_new_path(nh_list_node, ly_ctx, "outgoing-interface", (void *) if_name, 0, NULL);
-							if (ly_err != LY_SUCCESS) {
-								SRP_LOG_ERR("unable to create new outgoing-interface node");
-								goto error_out;
-							}
-
-							// next-hop-address
-							if (NEXTHOP_LIST->list[k].addr) {
-								nl_addr2str(NEXTHOP_LIST->list[k].addr, ip_buffer, sizeof(ip_buffer));
-								if (ADDR_FAMILY == AF_INET && ly_uv4mod != NULL) {
-									SRP_LOG_DBG("IPv4 next-hop/next-hop-list/next-hop/next-hop-address = %s", ip_buffer);
-									ly_err = lyd_new_term(nh_list_node, ly_uv4mod, "next-hop-address", ip_buffer, false, NULL);
-									if (ly_err != LY_SUCCESS) {
-										SRP_LOG_ERR("unable to create new IPv4 next-hop-address node");
-										goto error_out;
-									}
-								} else if (ADDR_FAMILY == AF_INET6 && ly_uv6mod != NULL) {
-									SRP_LOG_DBG("IPv6 next-hop/next-hop-list/next-hop/next-hop-address = %s", ip_buffer);
-									ly_err = lyd_new_term(nh_list_node, ly_uv6mod, "next-hop-address", ip_buffer, false, NULL);
-									if (ly_err != LY_SUCCESS) {
-										SRP_LOG_ERR("unable to create new IPv6 next-hop-address node");
-										goto error_out;
-									}
-								}
-							}
-							rtnl_link_put(iface);
-						}
-						break;
-					}
-				}
-
-				// destination-prefix
-				if (ADDR_FAMILY == AF_INET && ly_uv4mod != NULL) {
-					if (strncmp("none/0", prefix_buffer, strnlen(prefix_buffer, sizeof(prefix_buffer))) == 0) {
-						strcpy(prefix_buffer, "0.0.0.0/0");
-					}
-
-					SRP_LOG_DBG("destination-prefix = %s", prefix_buffer);
-					ly_err = lyd_new_term(ly_node, ly_uv4mod, "destination-prefix", prefix_buffer, false, NULL);
-					if (ly_err != LY_SUCCESS) {
-						SRP_LOG_ERR("unable to create new IPv4 destination-prefix node");
-						goto error_out;
-					}
-				} else if (ADDR_FAMILY == AF_INET6 && ly_uv6mod != NULL) {
-					if (strncmp("none/0", prefix_buffer, strnlen(prefix_buffer, sizeof(prefix_buffer))) == 0) {
-						strcpy(prefix_buffer, "::/0");
-					}
-
-					SRP_LOG_DBG("destination-prefix = %s", prefix_buffer);
-					ly_err = lyd_new_term(ly_node, ly_uv6mod, "destination-prefix", prefix_buffer, false, NULL);
-					if (ly_err != LY_SUCCESS) {
-						SRP_LOG_ERR("unable to create new IPv6 destination-prefix node");
+			}
+			break;
+		}
+		case route_next_hop_kind_special:
+			error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, "next-hop/special-next-hop", SR_ENUM_T, active->next_hop.value.special.value);
+			if (error != SR_ERR_OK) {
+				goto error_out;
+			}
+			break;
+		case route_next_hop_kind_list: {
+			const struct route_next_hop_list *NEXTHOP_LIST = &active->next_hop.value.list;
+
+			// keyless list - instances are addressed by position
+			for (size_t i = 0; i < NEXTHOP_LIST->size; i++) {
+				if (NEXTHOP_LIST->list[i].if_name) {
+					snprintf(node_buffer, sizeof(node_buffer), "next-hop/next-hop-list/next-hop[%zu]/outgoing-interface", i + 1);
+					error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, node_buffer, SR_STRING_T, NEXTHOP_LIST->list[i].if_name);
+					if (error != SR_ERR_OK) {
 						goto error_out;
 					}
 				}
 
-				// route-metadata/source-protocol
-				SRP_LOG_DBG("source-protocol = %s", ROUTE->metadata.source_protocol);
-				ly_err = lyd_new_path(ly_node, ly_ctx, "source-protocol", ROUTE->metadata.source_protocol, 0, NULL);
-				if (ly_err != LY_SUCCESS) {
-					SRP_LOG_ERR("unable to create new source-protocol node");
-					goto error_out;
-				}
-
-				// route-metadata/active
-				if (ROUTE->metadata.active == 1) {
-					SRP_LOG_DBG("active = %d", ROUTE->metadata.active);
-					ly_err = lyd_new_path(ly_node, ly_ctx, "active", NULL, 0, NULL);
-					if (ly_err != LY_SUCCESS) {
-						SRP_LOG_ERR("unable to create new active node");
+				if (NEXTHOP_LIST->list[i].addr) {
+					nl_addr2str(NEXTHOP_LIST->list[i].addr, ip_buffer, sizeof(ip_buffer));
+					snprintf(node_buffer, sizeof(node_buffer), "next-hop/next-hop-list/next-hop[%zu]/%s:next-hop-address", i + 1, af_module);
+					error = routing_rpc_active_route_set_value(&values[values_idx++], xpath, node_buffer, SR_STRING_T, ip_buffer);
+					if (error != SR_ERR_OK) {
 						goto error_out;
 					}
 				}
 			}
+			break;
 		}
 	}
 
-	if (error != 0) {
-		goto error_out;
-	}
+	*output = values;
+	*output_cnt = values_idx;
+	values = NULL;
 
 	goto out;
 
 error_out:
-	SRP_LOG_ERR("unable to return routes for routing tables");
+	SRP_LOG_ERR("unable to get the active route for %s", xpath);
 	error = SR_ERR_CALLBACK_FAILED;
 
 out:
-	rib_list_free(&ribs);
-	nl_socket_free(socket);
-	nl_cache_free(cache);
-	nl_cache_free(link_cache);
+	pthread_mutex_unlock(&routing_ribs_lock);
+
+	if (values) {
+		sr_free_values(values, values_cnt);
+	}
+	if (dst_addr) {
+		nl_addr_put(dst_addr);
+	}
+	FREE_SAFE(xpath_copy);
+
 	return error;
 }
 
-static int routing_rpc_active_route_cb(sr_session_ctx_t *session, uint32_t subscription_id, const char *xpath, const sr_val_t *input, const size_t input_cnt, sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt, void *private_data)
+static int routing_rpc_active_route_set_value(sr_val_t *value, const char *xpath, const char *node, sr_type_t type, const char *data)
 {
 	int error = SR_ERR_OK;
-	SRP_LOG_DBG("xpath for RPC: %s", xpath);
+	char path_buffer[PATH_MAX] = {0};
+
+	snprintf(path_buffer, sizeof(path_buffer), "%s/route/%s", xpath, node);
+
+	error = sr_val_set_xpath(value, path_buffer);
+	if (error != SR_ERR_OK) {
+		SRP_LOG_ERR("sr_val_set_xpath error (%d): %s", error, sr_strerror(error));
+		return error;
+	}
+
+	if (type == SR_LEAF_EMPTY_T) {
+		value->type = SR_LEAF_EMPTY_T;
+	} else {
+		error = sr_val_set_str_data(value, type, data ? data : "");
+		if (error != SR_ERR_OK) {
+			SRP_LOG_ERR("sr_val_set_str_data error (%d): %s", error, sr_strerror(error));
+			return error;
+		}
+	}
+
 	return error;
 }
 
@@ -1530,17 +2154,14 @@ static int routing_load_ribs(sr_session_ctx_t *session, struct lyd_node *routing
 {
 	// error handling
 	int error = 0;
-	int nl_err = 0;
 	LY_ERR ly_err = LY_SUCCESS;
 
 	// libyang
 	struct lyd_node *ribs_node = NULL, *rib_node = NULL, *added_node = NULL;
 	const struct ly_ctx *ly_ctx = NULL;
 
-	// libnl
-	struct nl_sock *socket = NULL;
-	struct nl_cache *cache = NULL;
-	struct rib_list ribs = {0};
+	// RIBs collected by routing_rib_cache_init()
+	const struct rib_list *ribs = &routing_ribs;
 
 	// temp buffers
 	char list_buffer[PATH_MAX] = {0};
@@ -1552,42 +2173,7 @@ static int routing_load_ribs(sr_session_ctx_t *session, struct lyd_node *routing
 		goto error_out;
 	}
 
-	rib_list_init(&ribs);
-
-	socket = nl_socket_alloc();
-	if (socket == NULL) {
-		SRP_LOG_ERR("unable to init nl_sock struct...");
-		goto error_out;
-	}
-
-	nl_err = nl_connect(socket, NETLINK_ROUTE);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("nl_connect failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	nl_err = rtnl_route_alloc_cache(socket, AF_UNSPEC, 0, &cache);
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_alloc_cache failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	nl_err = rtnl_route_read_table_names("/etc/iproute2/rt_tables");
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	nl_err = rtnl_route_read_protocol_names("/etc/iproute2/rt_protos");
-	if (nl_err != 0) {
-		SRP_LOG_ERR("rtnl_route_read_table_names failed (%d): %s", nl_err, nl_geterror(nl_err));
-		goto error_out;
-	}
-
-	error = routing_collect_ribs(cache, &ribs);
-	if (error != 0) {
-		goto error_out;
-	}
+	pthread_mutex_lock(&routing_ribs_lock);
 
 	ly_err = lyd_new_path(routing_container_node, ly_ctx, ROUTING_RIBS_CONTAINER_YANG_PATH, NULL, 0, &ribs_node);
 	if (ly_err != LY_SUCCESS) {
@@ -1597,8 +2183,8 @@ static int routing_load_ribs(sr_session_ctx_t *session, struct lyd_node *routing
 
 	// all RIBs loaded - add them to the initial config
 	struct rib *iter = NULL;
-	for (size_t i = 0; i < ribs.size; i++) {
-		iter = &ribs.list[i];
+	for (size_t i = 0; i < ribs->size; i++) {
+		iter = &ribs->list[i];
 		SRP_LOG_DBG("adding table %s to the list", iter->name);
 
 		// write the current adding table into the buffer
@@ -1632,9 +2218,7 @@ error_out:
 	error = -1;
 
 out:
-	rib_list_free(&ribs);
-	nl_socket_free(socket);
-	nl_cache_free(cache);
+	pthread_mutex_unlock(&routing_ribs_lock);
 
 	return error;
 }
@@ -1681,16 +2265,13 @@ out:
 	return error;
 }
 
-static int routing_collect_routes(struct nl_cache *routes_cache, struct nl_cache *link_cache, struct rib_list *ribs)
+static int routing_collect_routes(struct nl_cache *routes_cache, struct rib_list *ribs)
 {
 	int error = 0;
 	struct rtnl_route *route = NULL;
 	struct route tmp_route = {0};
 	char table_buffer[32] = {0};
 	struct rib *tmp_rib = NULL;
-	struct rtnl_link *iface = NULL;
-	int ifindex = 0;
-	char *if_name = NULL;
 
 	error = routing_collect_ribs(routes_cache, ribs);
 	if (error != 0) {
@@ -1712,64 +2293,53 @@ static int routing_collect_routes(struct nl_cache *routes_cache, struct nl_cache
 			goto error_out;
 		}
 
-		// fill the route with info and add to the hash of the current RIB
-		route_init(&tmp_route);
-		route_set_preference(&tmp_route, rtnl_route_get_priority(route));
-
-		// next-hop container -> TODO: see what about special type
-		const int NEXTHOP_COUNT = rtnl_route_get_nnexthops(route);
-		if (NEXTHOP_COUNT == 1) {
-			struct rtnl_nexthop *nh = rtnl_route_nexthop_n(route, 0);
-			ifindex = rtnl_route_nh_get_ifindex(nh);
-			iface = rtnl_link_get(link_cache, ifindex);
-			if_name = rtnl_link_get_name(iface);
-			route_next_hop_set_simple(&tmp_route.next_hop, ifindex, if_name, rtnl_route_nh_get_gateway(nh));
-
-			// free recieved link
-			rtnl_link_put(iface);
-		} else {
-			rtnl_route_foreach_nexthop(route, foreach_nexthop, &tmp_route.next_hop);
-		}
-
-		// route-metadata/source-protocol
-		if (rtnl_route_get_protocol(route) == RTPROT_STATIC) {
-			route_set_source_protocol(&tmp_route, "ietf-routing:static");
-		} else {
-			route_set_source_protocol(&tmp_route, "ietf-routing:direct");
-		}
-
-		// add the created route to the hash by a destination address
-		route_list_hash_add(&tmp_rib->routes, rtnl_route_get_dst(route), &tmp_route);
+		// add the created route to the hash and the prefix trie by a destination address - the active flag is maintained there
+		routing_build_route(route, &tmp_route);
+		rib_add_route(tmp_rib, rtnl_route_get_dst(route), &tmp_route);
 
-		// last-updated -> TODO: implement later
-		route_free(&tmp_route);
 		route = (struct rtnl_route *) nl_cache_get_next((struct nl_object *) route);
 	}
 
-	for (size_t i = 0; i < ribs->size; i++) {
-		const struct route_list_hash *routes_hash = &ribs->list[i].routes;
-		if (routes_hash->size) {
-			// iterate every "hash" and set the active value for the preferred route
-			for (size_t j = 0; j < routes_hash->size; j++) {
-				struct route_list *ls = &routes_hash->list_route[j];
-				if (ls->size > 0) {
-					struct route *pref = &ls->list[0];
-					for (size_t k = 1; k < ls->size; k++) {
-						struct route *ptr = &ls->list[k];
-						if (ptr->preference < pref->preference) {
-							pref = ptr;
-						}
-					}
-					pref->metadata.active = 1;
-				}
-			}
-		}
-	}
-
 error_out:
 	return error;
 }
 
+// called with routing_ribs_lock held - next-hop names are resolved from the shared ifindex table
+static void routing_build_route(struct rtnl_route *route, struct route *out)
+{
+	int ifindex = 0;
+	const char *if_name = NULL;
+
+	// fill the route with info
+	route_init(out);
+	route_set_preference(out, rtnl_route_get_priority(route));
+	route_set_tos(out, rtnl_route_get_tos(route));
+	route_set_type(out, rtnl_route_get_type(route));
+
+	// next-hop container -> TODO: see what about special type
+	const int NEXTHOP_COUNT = rtnl_route_get_nnexthops(route);
+	if (NEXTHOP_COUNT == 1) {
+		struct rtnl_nexthop *nh = rtnl_route_nexthop_n(route, 0);
+		ifindex = rtnl_route_nh_get_ifindex(nh);
+
+		// the link can already be gone when a route event is processed - no outgoing-interface then
+		if_name = link_names_get(&routing_link_names, ifindex);
+		route_next_hop_set_simple(&out->next_hop, ifindex, if_name, rtnl_route_nh_get_gateway(nh));
+	} else if (NEXTHOP_COUNT > 1) {
+		route_next_hop_reserve_list(&out->next_hop, (size_t) NEXTHOP_COUNT);
+		rtnl_route_foreach_nexthop(route, foreach_nexthop, &out->next_hop);
+	}
+
+	// route-metadata/source-protocol
+	if (rtnl_route_get_protocol(route) == RTPROT_STATIC) {
+		route_set_source_protocol(out, "ietf-routing:static");
+	} else {
+		route_set_source_protocol(out, "ietf-routing:direct");
+	}
+
+	// last-updated -> TODO: implement later
+}
+
 static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struct lyd_node *routing_container_node)
 {
 	// error handling
@@ -1924,10 +2494,12 @@ static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struc
 									goto error_out;
 								}
 
-								ly_err = lyd_new_term(nh_node, ly_uv4mod, "outgoing-interface", NEXTHOP->simple.if_name, false, &tmp_node);
-								if (ly_err != LY_SUCCESS) {
-									SRP_LOG_ERR("unable to create outgoing-interface leaf for the node %s", route_path_buffer);
-									goto error_out;
+								if (NEXTHOP->simple.if_name) {
+									ly_err = lyd_new_term(nh_node, ly_uv4mod, "outgoing-interface", NEXTHOP->simple.if_name, false, &tmp_node);
+									if (ly_err != LY_SUCCESS) {
+										SRP_LOG_ERR("unable to create outgoing-interface leaf for the node %s", route_path_buffer);
+										goto error_out;
+									}
 								}
 							}
 							break;
@@ -1959,10 +2531,12 @@ static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struc
 										goto error_out;
 									}
 
-									ly_err = lyd_new_term(nh_list_node, ly_uv4mod, "outgoing-interface", NEXTHOP_LIST->list[k].if_name, false, &tmp_node);
-									if (ly_err != LY_SUCCESS) {
-										SRP_LOG_ERR("unable to create outgoing-interface leaf in the list for route %s", route_path_buffer);
-										goto error_out;
+									if (NEXTHOP_LIST->list[k].if_name) {
+										ly_err = lyd_new_term(nh_list_node, ly_uv4mod, "outgoing-interface", NEXTHOP_LIST->list[k].if_name, false, &tmp_node);
+										if (ly_err != LY_SUCCESS) {
+											SRP_LOG_ERR("unable to create outgoing-interface leaf in the list for route %s", route_path_buffer);
+											goto error_out;
+										}
 									}
 								}
 							}
@@ -2021,10 +2595,12 @@ static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struc
 									goto error_out;
 								}
 
-								ly_err = lyd_new_term(nh_node, ly_uv6mod, "outgoing-interface", NEXTHOP->simple.if_name, false, &tmp_node);
-								if (ly_err != LY_SUCCESS) {
-									SRP_LOG_ERR("unable to create outgoing-interface leaf for the node %s", route_path_buffer);
-									goto error_out;
+								if (NEXTHOP->simple.if_name) {
+									ly_err = lyd_new_term(nh_node, ly_uv6mod, "outgoing-interface", NEXTHOP->simple.if_name, false, &tmp_node);
+									if (ly_err != LY_SUCCESS) {
+										SRP_LOG_ERR("unable to create outgoing-interface leaf for the node %s", route_path_buffer);
+										goto error_out;
+									}
 								}
 							}
 							break;
@@ -2054,10 +2630,12 @@ static int routing_load_control_plane_protocols(sr_session_ctx_t *session, struc
 										goto error_out;
 									}
 
-									ly_err = lyd_new_term(nh_list_node, ly_uv6mod, "outgoing-interface", NEXTHOP_LIST->list[k].if_name, false, &tmp_node);
-									if (ly_err != LY_SUCCESS) {
-										SRP_LOG_ERR("unable to create outgoing-interface leaf in the list for route %s", route_path_buffer);
-										goto error_out;
+									if (NEXTHOP_LIST->list[k].if_name) {
+										ly_err = lyd_new_term(nh_list_node, ly_uv6mod, "outgoing-interface", NEXTHOP_LIST->list[k].if_name, false, &tmp_node);
+										if (ly_err != LY_SUCCESS) {
+											SRP_LOG_ERR("unable to create outgoing-interface leaf in the list for route %s", route_path_buffer);
+											goto error_out;
+										}
 									}
 								}
 							}
@@ -2197,6 +2775,7 @@ out:
 	return error;
 }
 
+// libnl doesn't write the prefix length for host prefixes and writes "none" for default routes
 static inline int routing_is_rib_known(int table)
 {
 	return table == RT_TABLE_DEFAULT || table == RT_TABLE_LOCAL || table == RT_TABLE_MAIN;
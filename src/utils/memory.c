@@ -8,11 +8,26 @@
  * https://www.sartura.hr/
  */
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "memory.h"
 
+#define MEMORY_ARENA_DEFAULT_BLOCK_SIZE 65536
+#define MEMORY_ARENA_ALIGN (2 * sizeof(void *))
+#define MEMORY_INTERN_INITIAL_SIZE 32
+
+struct memory_arena_block {
+	struct memory_arena_block *next;
+	size_t size;
+	size_t used;
+	unsigned char data[];
+};
+
+static uint32_t memory_intern_hash(const char *s);
+static void memory_intern_resize(struct memory_intern *intern, size_t table_size);
+
 void *xmalloc(size_t size)
 {
 	void *res;
@@ -77,3 +92,138 @@ char *xstrndup(const char *s, size_t size)
 
 	return res;
 }
+
+void memory_arena_init(struct memory_arena *arena, size_t block_size)
+{
+	arena->head = NULL;
+	arena->block_size = block_size;
+}
+
+void *memory_arena_alloc(struct memory_arena *arena, size_t size)
+{
+	struct memory_arena_block *block = arena->head;
+	size_t pad = 0;
+
+	if (block != NULL) {
+		pad = (size_t) (-(uintptr_t) (block->data + block->used)) & (MEMORY_ARENA_ALIGN - 1);
+	}
+
+	if (block == NULL || block->used + pad + size > block->size) {
+		const size_t BLOCK_SIZE = arena->block_size ? arena->block_size : MEMORY_ARENA_DEFAULT_BLOCK_SIZE;
+		// oversized requests get a block of their own
+		const size_t DATA_SIZE = size + MEMORY_ARENA_ALIGN > BLOCK_SIZE ? size + MEMORY_ARENA_ALIGN : BLOCK_SIZE;
+
+		block = xmalloc(sizeof(struct memory_arena_block) + DATA_SIZE);
+		block->next = arena->head;
+		block->size = DATA_SIZE;
+		block->used = 0;
+		arena->head = block;
+
+		pad = (size_t) (-(uintptr_t) block->data) & (MEMORY_ARENA_ALIGN - 1);
+	}
+
+	block->used += pad;
+	void *res = block->data + block->used;
+	block->used += size;
+
+	return res;
+}
+
+char *memory_arena_strdup(struct memory_arena *arena, const char *s)
+{
+	const size_t SIZE = strlen(s) + 1;
+	char *res = memory_arena_alloc(arena, SIZE);
+
+	memcpy(res, s, SIZE);
+
+	return res;
+}
+
+void memory_arena_free(struct memory_arena *arena)
+{
+	struct memory_arena_block *block = arena->head;
+
+	while (block != NULL) {
+		struct memory_arena_block *next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->head = NULL;
+}
+
+void memory_intern_init(struct memory_intern *intern)
+{
+	memory_arena_init(&intern->arena, 0);
+	intern->table = NULL;
+	intern->table_size = 0;
+	intern->count = 0;
+}
+
+// returns the pooled copy of s - the copy is made on the first lookup of a string
+const char *memory_intern_get(struct memory_intern *intern, const char *s)
+{
+	const uint32_t KEY = memory_intern_hash(s);
+	size_t slot = 0;
+
+	if ((intern->count + 1) * 2 > intern->table_size) {
+		memory_intern_resize(intern, intern->table_size ? intern->table_size * 2 : MEMORY_INTERN_INITIAL_SIZE);
+	}
+
+	slot = KEY & (intern->table_size - 1);
+	while (intern->table[slot] != NULL) {
+		if (strcmp(intern->table[slot], s) == 0) {
+			return intern->table[slot];
+		}
+		slot = (slot + 1) & (intern->table_size - 1);
+	}
+
+	intern->table[slot] = memory_arena_strdup(&intern->arena, s);
+	intern->count += 1;
+
+	return intern->table[slot];
+}
+
+void memory_intern_free(struct memory_intern *intern)
+{
+	if (intern->table) {
+		FREE_SAFE(intern->table);
+	}
+	memory_arena_free(&intern->arena);
+	memory_intern_init(intern);
+}
+
+// FNV-1a
+static uint32_t memory_intern_hash(const char *s)
+{
+	uint32_t key = 2166136261u;
+
+	for (const unsigned char *ptr = (const unsigned char *) s; *ptr; ptr++) {
+		key = (key ^ *ptr) * 16777619u;
+	}
+
+	return key;
+}
+
+static void memory_intern_resize(struct memory_intern *intern, size_t table_size)
+{
+	const char **old_table = intern->table;
+	const size_t OLD_SIZE = intern->table_size;
+
+	intern->table = xcalloc(table_size, sizeof(const char *));
+	intern->table_size = table_size;
+
+	for (size_t i = 0; i < OLD_SIZE; i++) {
+		if (old_table[i] != NULL) {
+			size_t slot = memory_intern_hash(old_table[i]) & (table_size - 1);
+			while (intern->table[slot] != NULL) {
+				slot = (slot + 1) & (table_size - 1);
+			}
+			intern->table[slot] = old_table[i];
+		}
+	}
+
+	if (old_table) {
+		free((void *) old_table);
+	}
+}
@@ -25,4 +25,31 @@ void *xcalloc(size_t nmemb, size_t size);
 char *xstrdup(const char *s);
 char *xstrndup(const char *s, size_t size);
 
+// bump allocator - allocations are carved out of large blocks and released all at once by memory_arena_free()
+// a zeroed struct is a valid empty arena which uses the default block size
+struct memory_arena_block;
+
+struct memory_arena {
+	struct memory_arena_block *head;
+	size_t block_size;
+};
+
+void memory_arena_init(struct memory_arena *arena, size_t block_size);
+void *memory_arena_alloc(struct memory_arena *arena, size_t size);
+char *memory_arena_strdup(struct memory_arena *arena, const char *s);
+void memory_arena_free(struct memory_arena *arena);
+
+// string interning pool - equal strings share one arena allocation which lives until memory_intern_free()
+// a zeroed struct is a valid empty pool
+struct memory_intern {
+	struct memory_arena arena;
+	const char **table; // open addressing (linear probing) table, power of two size, kept at most half full
+	size_t table_size;
+	size_t count;
+};
+
+void memory_intern_init(struct memory_intern *intern);
+const char *memory_intern_get(struct memory_intern *intern, const char *s);
+void memory_intern_free(struct memory_intern *intern);
+
 #endif /* MEMORY_H_ONCE */
@@ -0,0 +1,196 @@
+/*
+ * Microbenchmark for the RIB oper data serializer - measures the time needed to build
+ * the routes subtree of a RIB with 100k IPv4 routes using path based node creation
+ * (lyd_new_path for every node) and using the resolved schema nodes (rib/tree.c).
+ *
+ * usage: rib_tree_bench [count...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netlink/addr.h>
+#include <libyang/libyang.h>
+
+#include "link_names.h"
+#include "rib.h"
+#include "route.h"
+#include "route/list_hash.h"
+#include "rib/tree.h"
+
+#define BENCH_RIB_YANG_PATH "/ietf-routing:routing/ribs/rib[name='ipv4-main']"
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end);
+static struct nl_addr *bench_build_prefix(size_t i);
+static int bench_build_paths(const struct ly_ctx *ly_ctx, struct lyd_node *routes_node, struct route_list_hash *hash);
+static int bench_build_schema(const struct rib_tree_schema *schema, struct lyd_node *routes_node, struct route_list_hash *hash, const struct link_names *names);
+static int bench_run(const struct ly_ctx *ly_ctx, size_t count);
+
+int main(int argc, char **argv)
+{
+	const size_t DEFAULT_COUNTS[] = {10000, 100000};
+	struct ly_ctx *ly_ctx = NULL;
+	int error = 0;
+
+	if (ly_ctx_new(ROUTING_BENCH_YANG_DIR, 0, &ly_ctx) != LY_SUCCESS) {
+		fprintf(stderr, "unable to create libyang context\n");
+		return EXIT_FAILURE;
+	}
+
+	if (ly_ctx_load_module(ly_ctx, "ietf-routing", "2018-03-13", NULL) == NULL || ly_ctx_load_module(ly_ctx, "ietf-ipv4-unicast-routing", "2018-03-13", NULL) == NULL) {
+		fprintf(stderr, "unable to load routing modules from %s\n", ROUTING_BENCH_YANG_DIR);
+		ly_ctx_destroy(ly_ctx);
+		return EXIT_FAILURE;
+	}
+
+	printf("%10s %14s %14s\n", "routes", "paths [ms]", "schema [ms]");
+
+	if (argc > 1) {
+		for (int i = 1; i < argc && error == 0; i++) {
+			error = bench_run(ly_ctx, strtoul(argv[i], NULL, 10));
+		}
+	} else {
+		for (size_t i = 0; i < sizeof(DEFAULT_COUNTS) / sizeof(DEFAULT_COUNTS[0]) && error == 0; i++) {
+			error = bench_run(ly_ctx, DEFAULT_COUNTS[i]);
+		}
+	}
+
+	ly_ctx_destroy(ly_ctx);
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end)
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1e3 + (double) (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// every i gets a distinct /24 - /32 prefix, similar to the bulk of a full BGP table
+static struct nl_addr *bench_build_prefix(size_t i)
+{
+	const unsigned int PREFIXLEN = 24 + (unsigned int) (i % 9);
+	uint32_t addr = htonl(0x01000000u + ((uint32_t) i << 8));
+	struct nl_addr *prefix = nl_addr_build(AF_INET, &addr, sizeof(addr));
+
+	nl_addr_set_prefixlen(prefix, (int) PREFIXLEN);
+
+	return prefix;
+}
+
+// node creation as done by the RIB oper callback before the schema based serializer
+static int bench_build_paths(const struct ly_ctx *ly_ctx, struct lyd_node *routes_node, struct route_list_hash *hash)
+{
+	const struct lys_module *ly_uv4mod = ly_ctx_get_module_implemented(ly_ctx, "ietf-ipv4-unicast-routing");
+	struct lyd_node *route_node = NULL, *nh_node = NULL;
+	char value_buffer[16] = {0};
+	char prefix_buffer[INET6_ADDRSTRLEN + 1 + 3] = {0};
+	char ip_buffer[INET6_ADDRSTRLEN] = {0};
+
+	for (size_t i = 0; i < hash->size; i++) {
+		const struct route *ROUTE = &hash->list_route[i].list[0];
+
+		// nl_addr2str leaves out the prefix length of host routes - the ipv4-prefix pattern requires it
+		rib_prefix_to_str(hash->list_addr[i], AF_INET, prefix_buffer, sizeof(prefix_buffer));
+		snprintf(value_buffer, sizeof(value_buffer), "%u", ROUTE->preference);
+
+		if (lyd_new_list(routes_node, NULL, "route", false, &route_node) != LY_SUCCESS ||
+			lyd_new_path(route_node, ly_ctx, "route-preference", value_buffer, 0, NULL) != LY_SUCCESS ||
+			lyd_new_path(route_node, ly_ctx, "next-hop", NULL, 0, &nh_node) != LY_SUCCESS ||
+			lyd_new_path(nh_node, ly_ctx, "outgoing-interface", ROUTE->next_hop.value.simple.if_name, 0, NULL) != LY_SUCCESS ||
+			lyd_new_term(nh_node, ly_uv4mod, "next-hop-address", nl_addr2str(ROUTE->next_hop.value.simple.addr, ip_buffer, sizeof(ip_buffer)), false, NULL) != LY_SUCCESS ||
+			lyd_new_term(route_node, ly_uv4mod, "destination-prefix", prefix_buffer, false, NULL) != LY_SUCCESS ||
+			lyd_new_path(route_node, ly_ctx, "source-protocol", ROUTE->metadata.source_protocol, 0, NULL) != LY_SUCCESS ||
+			lyd_new_path(route_node, ly_ctx, "active", NULL, 0, NULL) != LY_SUCCESS) {
+			fprintf(stderr, "unable to create route %zu\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int bench_build_schema(const struct rib_tree_schema *schema, struct lyd_node *routes_node, struct route_list_hash *hash, const struct link_names *names)
+{
+	for (size_t i = 0; i < hash->size; i++) {
+		if (rib_tree_add_route_list(schema, routes_node, AF_INET, hash->list_addr[i], &hash->list_route[i], names) != 0) {
+			fprintf(stderr, "unable to create route %zu\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int bench_run(const struct ly_ctx *ly_ctx, size_t count)
+{
+	int error = 0;
+	struct route_list_hash hash = {0};
+	struct link_names names = {0};
+	struct rib_tree_schema schema = {0};
+	struct route tmp_route = {0};
+	struct nl_addr *prefix = NULL;
+	struct nl_addr *gateway = NULL;
+	struct lyd_node *tree = NULL, *routes_node = NULL;
+	struct timespec start = {0}, end = {0};
+	double paths_ms = 0, schema_ms = 0;
+
+	route_list_hash_init(&hash);
+	link_names_init(&names);
+	link_names_set(&names, 2, "eth0");
+
+	if (nl_addr_parse("192.0.2.1", AF_INET, &gateway) != 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		route_init(&tmp_route);
+		route_set_preference(&tmp_route, 100);
+		route_set_source_protocol(&tmp_route, "ietf-routing:static");
+		route_set_active(&tmp_route, true);
+		route_next_hop_set_simple(&tmp_route.next_hop, 2, "eth0", gateway);
+
+		prefix = bench_build_prefix(i);
+		route_list_hash_add(&hash, prefix, &tmp_route);
+		nl_addr_put(prefix);
+	}
+
+	for (int method = 0; method < 2 && error == 0; method++) {
+		if (lyd_new_path(NULL, ly_ctx, BENCH_RIB_YANG_PATH "/routes", NULL, 0, &tree) != LY_SUCCESS || lyd_find_path(tree, BENCH_RIB_YANG_PATH "/routes", false, &routes_node) != LY_SUCCESS) {
+			fprintf(stderr, "unable to create routes container\n");
+			error = -1;
+			break;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if (method == 0) {
+			error = bench_build_paths(ly_ctx, routes_node, &hash);
+		} else {
+			// resolving the schema nodes is a part of the measured time
+			error = rib_tree_schema_init(&schema, ly_ctx);
+			if (error == 0) {
+				error = bench_build_schema(&schema, routes_node, &hash, &names);
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		if (method == 0) {
+			paths_ms = bench_elapsed_ms(&start, &end);
+		} else {
+			schema_ms = bench_elapsed_ms(&start, &end);
+		}
+
+		lyd_free_all(tree);
+		tree = NULL;
+	}
+
+	if (error == 0) {
+		printf("%10zu %14.2f %14.2f\n", count, paths_ms, schema_ms);
+	}
+
+	nl_addr_put(gateway);
+	link_names_free(&names);
+	route_list_hash_free(&hash);
+
+	return error;
+}
@@ -0,0 +1,191 @@
+/*
+ * Benchmark for struct route_batch - measures the time needed to add and delete
+ * count IPv4 /24 blackhole routes with one acked request per route (rtnl_route_add/rtnl_route_delete)
+ * and with route_batch.
+ *
+ * the routes are installed in the main table, so run it in a separate network namespace:
+ *   unshare -rn route_batch_bench [count...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+#include <netlink/addr.h>
+#include <netlink/netlink.h>
+#include <netlink/route/route.h>
+
+#include "route/batch.h"
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end);
+static struct rtnl_route *bench_build_route(size_t i);
+static int bench_sequential(struct rtnl_route **routes, size_t count, double *add_ms, double *delete_ms);
+static int bench_batch(struct rtnl_route **routes, size_t count, double *add_ms, double *delete_ms);
+static int bench_run(size_t count);
+
+int main(int argc, char **argv)
+{
+	const size_t DEFAULT_COUNTS[] = {10000, 50000, 100000};
+	int error = 0;
+
+	printf("%10s %16s %16s %16s %16s\n", "routes", "seq add [ms]", "seq del [ms]", "batch add [ms]", "batch del [ms]");
+
+	if (argc > 1) {
+		for (int i = 1; i < argc && error == 0; i++) {
+			error = bench_run(strtoul(argv[i], NULL, 10));
+		}
+	} else {
+		for (size_t i = 0; i < sizeof(DEFAULT_COUNTS) / sizeof(DEFAULT_COUNTS[0]) && error == 0; i++) {
+			error = bench_run(DEFAULT_COUNTS[i]);
+		}
+	}
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end)
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1e3 + (double) (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// blackhole routes need no link or next hop - static routes of the main table, as the plugin installs them
+static struct rtnl_route *bench_build_route(size_t i)
+{
+	uint32_t addr = htonl(0x01000000u + ((uint32_t) i << 8));
+	struct nl_addr *dst = nl_addr_build(AF_INET, &addr, sizeof(addr));
+	struct rtnl_route *route = rtnl_route_alloc();
+
+	nl_addr_set_prefixlen(dst, 24);
+
+	rtnl_route_set_family(route, AF_INET);
+	rtnl_route_set_table(route, RT_TABLE_MAIN);
+	rtnl_route_set_protocol(route, RTPROT_STATIC);
+	rtnl_route_set_scope(route, RT_SCOPE_UNIVERSE);
+	rtnl_route_set_type(route, RTN_BLACKHOLE);
+	rtnl_route_set_dst(route, dst);
+
+	nl_addr_put(dst);
+
+	return route;
+}
+
+static int bench_sequential(struct rtnl_route **routes, size_t count, double *add_ms, double *delete_ms)
+{
+	int error = 0;
+	struct nl_sock *socket = NULL;
+	struct timespec start = {0}, end = {0};
+
+	socket = nl_socket_alloc();
+	if (socket == NULL || nl_connect(socket, NETLINK_ROUTE) != 0) {
+		fprintf(stderr, "unable to connect the netlink socket\n");
+		error = -1;
+		goto out;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < count && error == 0; i++) {
+		error = rtnl_route_add(socket, routes[i], NLM_F_CREATE | NLM_F_REPLACE);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*add_ms = bench_elapsed_ms(&start, &end);
+
+	if (error != 0) {
+		fprintf(stderr, "rtnl_route_add failed (%d): %s\n", error, nl_geterror(error));
+		goto out;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < count && error == 0; i++) {
+		error = rtnl_route_delete(socket, routes[i], 0);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*delete_ms = bench_elapsed_ms(&start, &end);
+
+	if (error != 0) {
+		fprintf(stderr, "rtnl_route_delete failed (%d): %s\n", error, nl_geterror(error));
+	}
+
+out:
+	if (socket) {
+		nl_socket_free(socket);
+	}
+
+	return error;
+}
+
+static int bench_batch(struct rtnl_route **routes, size_t count, double *add_ms, double *delete_ms)
+{
+	int error = 0;
+	struct route_batch batch = {0};
+	struct timespec start = {0}, end = {0};
+
+	// the batch is created per commit, the same way update_static_routes does it
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	error = route_batch_init(&batch);
+	for (size_t i = 0; i < count && error == 0; i++) {
+		error = route_batch_add(&batch, routes[i], NLM_F_CREATE | NLM_F_REPLACE);
+	}
+	if (error == 0) {
+		error = route_batch_commit(&batch);
+	}
+	route_batch_free(&batch);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*add_ms = bench_elapsed_ms(&start, &end);
+
+	if (error != 0) {
+		fprintf(stderr, "batched add failed\n");
+		return error;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	error = route_batch_init(&batch);
+	for (size_t i = 0; i < count && error == 0; i++) {
+		error = route_batch_delete(&batch, routes[i], 0);
+	}
+	if (error == 0) {
+		error = route_batch_commit(&batch);
+	}
+	route_batch_free(&batch);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*delete_ms = bench_elapsed_ms(&start, &end);
+
+	if (error != 0) {
+		fprintf(stderr, "batched delete failed\n");
+	}
+
+	return error;
+}
+
+static int bench_run(size_t count)
+{
+	int error = 0;
+	struct rtnl_route **routes = NULL;
+	double seq_add_ms = 0, seq_delete_ms = 0;
+	double batch_add_ms = 0, batch_delete_ms = 0;
+
+	routes = calloc(count, sizeof(struct rtnl_route *));
+	if (routes == NULL) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		routes[i] = bench_build_route(i);
+	}
+
+	error = bench_sequential(routes, count, &seq_add_ms, &seq_delete_ms);
+	if (error == 0) {
+		error = bench_batch(routes, count, &batch_add_ms, &batch_delete_ms);
+	}
+
+	if (error == 0) {
+		printf("%10zu %16.1f %16.1f %16.1f %16.1f\n", count, seq_add_ms, seq_delete_ms, batch_add_ms, batch_delete_ms);
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		rtnl_route_put(routes[i]);
+	}
+	free(routes);
+
+	return error;
+}
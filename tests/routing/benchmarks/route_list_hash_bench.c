@@ -0,0 +1,108 @@
+/*
+ * Microbenchmark for struct route_list_hash - measures the time needed to build
+ * a prefix index of 10k/100k/1M IPv4 prefixes and to look every prefix up again.
+ *
+ * usage: route_list_hash_bench [count...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netlink/addr.h>
+
+#include "route.h"
+#include "route/list_hash.h"
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end);
+static struct nl_addr *bench_build_prefix(size_t i);
+static int bench_run(size_t count);
+
+int main(int argc, char **argv)
+{
+	const size_t DEFAULT_COUNTS[] = {10000, 100000, 1000000};
+	int error = 0;
+
+	printf("%10s %14s %14s\n", "prefixes", "build [ms]", "lookup [ms]");
+
+	if (argc > 1) {
+		for (int i = 1; i < argc && error == 0; i++) {
+			error = bench_run(strtoul(argv[i], NULL, 10));
+		}
+	} else {
+		for (size_t i = 0; i < sizeof(DEFAULT_COUNTS) / sizeof(DEFAULT_COUNTS[0]) && error == 0; i++) {
+			error = bench_run(DEFAULT_COUNTS[i]);
+		}
+	}
+
+	return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static double bench_elapsed_ms(struct timespec *start, struct timespec *end)
+{
+	return (double) (end->tv_sec - start->tv_sec) * 1e3 + (double) (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// every i gets a distinct /24 - /32 prefix, similar to the bulk of a full BGP table
+static struct nl_addr *bench_build_prefix(size_t i)
+{
+	const unsigned int PREFIXLEN = 24 + (unsigned int) (i % 9);
+	uint32_t addr = htonl(0x01000000u + ((uint32_t) i << 8));
+	struct nl_addr *prefix = nl_addr_build(AF_INET, &addr, sizeof(addr));
+
+	nl_addr_set_prefixlen(prefix, (int) PREFIXLEN);
+
+	return prefix;
+}
+
+static int bench_run(size_t count)
+{
+	int error = 0;
+	struct route_list_hash hash = {0};
+	struct nl_addr **prefixes = NULL;
+	struct route tmp_route = {0};
+	struct timespec start = {0}, end = {0};
+	double build_ms = 0, lookup_ms = 0;
+
+	prefixes = calloc(count, sizeof(struct nl_addr *));
+	if (prefixes == NULL) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		prefixes[i] = bench_build_prefix(i);
+	}
+
+	route_list_hash_init(&hash);
+	route_init(&tmp_route);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < count; i++) {
+		route_set_preference(&tmp_route, (uint32_t) i);
+		route_list_hash_add(&hash, prefixes[i], &tmp_route);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	build_ms = bench_elapsed_ms(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < count; i++) {
+		if (route_list_hash_get_by_addr(&hash, prefixes[i]) == NULL) {
+			fprintf(stderr, "prefix %zu not found\n", i);
+			error = -1;
+			break;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	lookup_ms = bench_elapsed_ms(&start, &end);
+
+	printf("%10zu %14.2f %14.2f\n", count, build_ms, lookup_ms);
+
+	route_free(&tmp_route);
+	route_list_hash_free(&hash);
+	for (size_t i = 0; i < count; i++) {
+		nl_addr_put(prefixes[i]);
+	}
+	free(prefixes);
+
+	return error;
+}